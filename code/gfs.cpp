@@ -1,5 +1,11 @@
 
 #include "gfs.h"
+#include "gfs_memory.cpp"
+#include "gfs_font.cpp"
+#include "gfs_debug.cpp"
+#include "gfs_particles.cpp"
+#include "gfs_audio.cpp"
+#include "gfs_render.cpp"
 
 //===============================================================
 // @Purpose: Test for rendering
@@ -10,40 +16,76 @@ int32 PlayerHeight = 24;
 int32 PosX = 100;
 int32 PosY = 100;
 
+// NOTE(oyvind): Longest step we simulate in one go, so a breakpoint or a hitch doesn't fling everything
+#define GAME_MAX_DT (1.0f / 10.0f)
 
+
+// NOTE(oyvind): Phase comes from the absolute sample index, so there is no state to
+// drift and any sample can be generated on its own.
 INTERNAL void OutputGameSound(gfs_sound_buffer* SoundBuffer)
 {
-    LOCALPERSIST real32 tSine;
     int16 ToneVolume = 3000;
     int ToneHz = 256;
     int WavePeriod = SoundBuffer->SamplesPerSecond / ToneHz;
 
     int16* SampleOut = SoundBuffer->Samples;
+    int PeriodIndex = (int)(SoundBuffer->RunningSampleIndex % WavePeriod);
     for ( int SampleIndex = 0; SampleIndex < SoundBuffer->SampleCount; ++SampleIndex )
     {
-        real32 SineValue = sinf( tSine );
+        real32 SineValue = sinf( 2.0f * PI32 * (real32)PeriodIndex / (real32)WavePeriod );
         int16 SampleValue = (int16)(SineValue * ToneVolume);
         *SampleOut++ = SampleValue;
         *SampleOut++ = SampleValue;
 
-        tSine += 2.0f * PI32 * 1.0f / (real32)WavePeriod;
+        if ( ++PeriodIndex == WavePeriod )
+        {
+            PeriodIndex = 0;
+        }
     }
 }
 
-INTERNAL void RenderWeirdPixelTest( gfs_offscreen_buffer* Buffer, int XOffset, int YOffset )
+// NOTE(oyvind): Soft-edged disc, to have something alpha blended to draw
+INTERNAL void MakeTestBitmap( loaded_bitmap* Bitmap, memory_arena* Arena, int32 Size )
 {
-    uint8* Row = (uint8*)Buffer->Memory;
+    Bitmap->Width = Size;
+    Bitmap->Height = Size;
+    Bitmap->Pitch = Size * 4;
+    Bitmap->Memory = PushArray( Arena, Size * Size, uint32, MemoryTag_Render );
 
-    for ( int Y = 0; Y < Buffer->Height; ++Y )
+    real32 Radius = 0.5f * (real32)Size;
+    uint32* Pixel = (uint32*)Bitmap->Memory;
+    for ( int Y = 0; Y < Size; ++Y )
     {
-        uint32* Pixel = (uint32*)Row;
-        for ( int X = 0; X < Buffer->Width; ++X )
+        for ( int X = 0; X < Size; ++X )
         {
-            *Pixel++ = (((XOffset) << 16) | ((YOffset) << 8) | 128);
+            real32 dX = (real32)X + 0.5f - Radius;
+            real32 dY = (real32)Y + 0.5f - Radius;
+            real32 Coverage = 1.0f - sqrtf( dX * dX + dY * dY ) / Radius;
+            if ( Coverage < 0.0f ) Coverage = 0.0f;
+
+            uint32 Alpha = (uint32)(255.0f * Coverage);
+            *Pixel++ = (Alpha << 24) | (0xFF << 16) | (0xC0 << 8) | (uint32)(0x40 + X * 0xBF / Size);
         }
-        Row += Buffer->Pitch;
+    }
+}
+
+INTERNAL void RenderWeirdPixelTest( render_group* RenderGroup, gfs_offscreen_buffer* Buffer, int XOffset, int YOffset, loaded_bitmap* TestBitmap, real32 SpriteAngle )
+{
+    PushClear( RenderGroup, (((XOffset) << 16) | ((YOffset) << 8) | 128) );
+
+    // NOTE(oyvind): Floor made of tiles. They share edges and color, so they merge into one fill.
+    int32 TileSize = 32;
+    for ( int32 TileX = 0; TileX < Buffer->Width; TileX += TileSize )
+    {
+        PushRectangle( RenderGroup, 1, (real32)TileX, (real32)(Buffer->Height - TileSize),
+            (real32)(TileX + TileSize), (real32)Buffer->Height, 0x00303030 );
     }
 
+    PushBitmap( RenderGroup, 2, TestBitmap, (real32)(Buffer->Width / 2 - TestBitmap->Width / 2), (real32)(Buffer->Height / 3) );
+
+    // NOTE(oyvind): Same bitmap as a rotated, scaled sprite, goes through the triangle rasterizer
+    PushSprite( RenderGroup, 2, TestBitmap, (real32)(Buffer->Width / 4), (real32)(Buffer->Height / 3), SpriteAngle, 2.0f );
+
     PosX += XOffset;
     PosY += -YOffset;
 
@@ -52,25 +94,90 @@ INTERNAL void RenderWeirdPixelTest( gfs_offscreen_buffer* Buffer, int XOffset, i
 
     if ( (PosX + PlayerWidth) >= Buffer->Width ) PosX = Buffer->Width - PlayerWidth - 2;
     if ( (PosY + PlayerHeight) >= Buffer->Height ) PosY = Buffer->Height - PlayerHeight - 2;
-    
-    Row = (uint8*)Buffer->Memory + (Buffer->Pitch * PosY);
 
-    for ( int Y = 0; Y < PlayerHeight; ++Y )
+    PushRectangle( RenderGroup, 3, (real32)PosX, (real32)PosY,
+        (real32)(PosX + PlayerWidth), (real32)(PosY + PlayerHeight), ((0 << 16) | (0 << 8) | 0) );
+}
+
+INTERNAL void GameUpdateAndRender( gfs_memory* Memory, gfs_offscreen_buffer* Buffer, int32 XOffset, int32 YOffset, gfs_sound_buffer* SoundBuffer, real32 SecondsElapsed )
+{
+    BEGIN_TIMED_BLOCK( GameUpdateAndRender );
+    GlobalDebugState = Memory->Debug;
+
+    Assert( sizeof( game_state ) <= Memory->PermanentStorageSize );
+
+    game_state* GameState = (game_state*)Memory->PermanentStorage;
+    if ( !Memory->IsInitialized )
     {
-        uint32* Pixel = (uint32*)Row + PosX;
-        for ( int X = 0; X < PlayerWidth; ++X )
+        InitializeArena( &GameState->PermanentArena,
+            Memory->PermanentStorageSize - sizeof( game_state ),
+            (uint8*)Memory->PermanentStorage + sizeof( game_state ),
+            false, Memory->Stats, "Permanent" );
+        InitializeArena( &GameState->TransientArena,
+            Memory->TransientStorageSize, Memory->TransientStorage,
+            true, Memory->Stats, "Transient" );
+
+        RecordPush( Memory->Stats, MemoryTag_GameState, sizeof( game_state ), false );
+
+        InitializeFontAtlas( &GameState->DebugFont, &GameState->PermanentArena, 1 );
+        InitializeParticleSystem( &GameState->Particles, &GameState->PermanentArena, MAX_PARTICLE_COUNT );
+        MakeTestBitmap( &GameState->TestBitmap, &GameState->PermanentArena, 64 );
+
+        // TODO(oyvind): Asset loading path. Missing file just means no music.
+        if ( Memory->PlatformAPI.OpenMappedFile )
         {
-            *Pixel++ = ((0 << 16) | (0 << 8) | 0);
+            OpenWavStream( &GameState->Music, &Memory->PlatformAPI, "data/music.wav", true );
         }
 
-        Row += Buffer->Pitch;
+        Memory->IsInitialized = true;
     }
-    
-}
 
-INTERNAL void GameUpdateAndRender( gfs_offscreen_buffer* Buffer, int32 XOffset, int32 YOffset, gfs_sound_buffer* SoundBuffer )
-{
-    // TODO(oyvind): Allow sample offsets here for more robust platform options
+    ResetArena( &GameState->TransientArena );
+
+    real32 dt = SecondsElapsed;
+    if ( dt > GAME_MAX_DT ) dt = GAME_MAX_DT;
+    if ( dt < 0.0f ) dt = 0.0f;
+
+    // NOTE(oyvind): Nothing below touches pixels until RenderGroupToOutput
+    render_group* RenderGroup = AllocateRenderGroup( &GameState->TransientArena, Kilobytes( 256 ), 4096 );
+
+    BEGIN_TIMED_BLOCK( Render );
+    GameState->TestSpriteAngle += 0.5f * PI32 * dt;
+    if ( GameState->TestSpriteAngle > 2.0f * PI32 ) GameState->TestSpriteAngle -= 2.0f * PI32;
+    RenderWeirdPixelTest( RenderGroup, Buffer, XOffset, YOffset, &GameState->TestBitmap, GameState->TestSpriteAngle );
+    END_TIMED_BLOCK( Render );
+
+    // NOTE(oyvind): Test event, blip exactly when the frame showing the player hitting an edge is flipped
+    bool32 PlayerIsTouchingEdge = (PosX == 0) || (PosY == 0) ||
+        (PosX + PlayerWidth >= Buffer->Width - 2) || (PosY + PlayerHeight >= Buffer->Height - 2);
+    if ( PlayerIsTouchingEdge && !GameState->PlayerWasTouchingEdge )
+    {
+        ScheduleSoundEvent( &GameState->SoundEvents, SoundBuffer, 0.0f, 880.0f, 0.08f, 6000.0f );
+    }
+    GameState->PlayerWasTouchingEdge = PlayerIsTouchingEdge;
+
+    // NOTE(oyvind): Sound goes after simulation, so events scheduled this frame make it into this buffer
+    BEGIN_TIMED_BLOCK( OutputGameSound );
     OutputGameSound( SoundBuffer);
-    RenderWeirdPixelTest( Buffer, XOffset, YOffset );
-}
\ No newline at end of file
+    END_TIMED_BLOCK( OutputGameSound );
+
+    MixSoundEvents( &GameState->SoundEvents, SoundBuffer );
+    MixWavStream( &GameState->Music, &Memory->PlatformAPI, SoundBuffer, &GameState->TransientArena );
+
+    // NOTE(oyvind): Test emitter trailing the player. 1s lifetime, so the rate is also the live count.
+    SpawnParticles( &GameState->Particles, (uint32)(120000.0f * dt),
+        (real32)(PosX + PlayerWidth / 2), (real32)(PosY + PlayerHeight / 2),
+        200.0f, 1.0f, 0x00402010 );
+    UpdateParticles( &GameState->Particles, dt );
+
+    RenderGroupToOutput( RenderGroup, Buffer );
+    RenderParticles( &GameState->Particles, Buffer );
+
+    END_TIMED_BLOCK( GameUpdateAndRender );
+
+    // NOTE(oyvind): Outside the GameUpdateAndRender block so the HUD does not count itself twice
+    if ( Memory->Debug && Memory->Debug->ShowHUD )
+    {
+        DrawDebugHUD( Memory->Debug, Buffer, &GameState->DebugFont );
+    }
+}
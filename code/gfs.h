@@ -14,8 +14,15 @@
            Building is done using Unity ("Jumbo") build.
 =================================================================*/
 #include <stdint.h>
+#include <stddef.h>
 #include <math.h> // TODO(oyvind): Implement SIN ourselves
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
 //===============================================================
 // Defines | platform+
 //===============================================================
@@ -41,6 +48,52 @@ typedef int32 bool32;
 typedef float real32;
 typedef double real64;
 
+typedef size_t memory_index;
+
+#define Kilobytes(Value) ((Value)*1024LL)
+#define Megabytes(Value) (Kilobytes(Value)*1024LL)
+#define Gigabytes(Value) (Megabytes(Value)*1024LL)
+
+#define ArrayCount(Array) (sizeof(Array) / sizeof((Array)[0]))
+
+#if defined(GFS_DEBUG)
+#define Assert(Expression) if(!(Expression)) {*(volatile int *)0 = 0;}
+#else
+#define Assert(Expression)
+#endif
+
+#include "gfs_memory.h"
+
+/*
+	NOTE(oyvind): Services that the platform layer provides to the game
+*/
+
+// NOTE(oyvind): Read-only file mapping. Only one window of the file is mapped at a time,
+// mapping a new window unmaps the previous one, so resident memory stays bounded by the window.
+struct platform_mapped_file {
+    uint64 Size;
+    void* FileHandle;
+    void* MappingHandle;
+    void* View;
+    memory_index ViewSize;
+};
+
+#define PLATFORM_OPEN_MAPPED_FILE(name) bool32 name( const char* FileName, platform_mapped_file* File )
+typedef PLATFORM_OPEN_MAPPED_FILE( platform_open_mapped_file );
+
+// NOTE(oyvind): Returns a pointer to the byte at Offset, valid for Size bytes until the next call for this file
+#define PLATFORM_MAP_FILE_WINDOW(name) uint8* name( platform_mapped_file* File, uint64 Offset, uint32 Size )
+typedef PLATFORM_MAP_FILE_WINDOW( platform_map_file_window );
+
+#define PLATFORM_CLOSE_MAPPED_FILE(name) void name( platform_mapped_file* File )
+typedef PLATFORM_CLOSE_MAPPED_FILE( platform_close_mapped_file );
+
+struct platform_api {
+    platform_open_mapped_file* OpenMappedFile;
+    platform_map_file_window* MapFileWindow;
+    platform_close_mapped_file* CloseMappedFile;
+};
+
 /*
 	NOTE(oyvind): Services that the game provides to the platform layer
 */
@@ -56,6 +109,31 @@ struct gfs_sound_buffer {
     int SampleCount;
     int SamplesPerSecond;
     int16* Samples;
+
+    // NOTE(oyvind): Absolute sample indices since playback started. Samples[0] is
+    // RunningSampleIndex, and FlipSampleIndex is the platform's estimate of the sample
+    // playing when this frame hits the screen. It can be before RunningSampleIndex on a
+    // card with a long write-cursor lead. The platform never asks for a sample twice,
+    // but it may skip ahead after a hitch.
+    uint64 RunningSampleIndex;
+    uint64 FlipSampleIndex;
+};
+
+struct gfs_debug_state;
+
+struct gfs_memory {
+    bool32 IsInitialized;
+
+    uint64 PermanentStorageSize;
+    void* PermanentStorage; // NOTE(oyvind): REQUIRED to be cleared to zero at startup
+
+    uint64 TransientStorageSize;
+    void* TransientStorage; // NOTE(oyvind): REQUIRED to be cleared to zero at startup
+
+    gfs_memory_stats* Stats; // NOTE(oyvind): Owned by the platform layer
+    gfs_debug_state* Debug;  // NOTE(oyvind): Owned by the platform layer
+
+    platform_api PlatformAPI;
 };
 
 //===============================================================
@@ -64,4 +142,28 @@ struct gfs_sound_buffer {
 // 
 // Needs: timing, input controller/keyboard, bitmap buffer to use, sound buffer to use
 //===============================================================
-INTERNAL void GameUpdateAndRender( gfs_offscreen_buffer* Buffer, int32 XOffset, int32 YOffset, gfs_sound_buffer* SoundBuffer );
+// NOTE(oyvind): SecondsElapsed is the measured length of the previous frame, the best guess for this one
+INTERNAL void GameUpdateAndRender( gfs_memory* Memory, gfs_offscreen_buffer* Buffer, int32 XOffset, int32 YOffset, gfs_sound_buffer* SoundBuffer, real32 SecondsElapsed );
+
+/*
+	NOTE(oyvind): Game internal
+*/
+
+#include "gfs_font.h"
+#include "gfs_debug.h"
+#include "gfs_render.h"
+#include "gfs_particles.h"
+#include "gfs_audio.h"
+
+struct game_state {
+    memory_arena PermanentArena; // Lives in PermanentStorage, right after game_state
+    memory_arena TransientArena; // Reset at the start of every frame
+
+    font_atlas DebugFont;
+    particle_system Particles;
+    loaded_bitmap TestBitmap;
+    real32 TestSpriteAngle;
+    wav_stream Music;
+    sound_event_queue SoundEvents;
+    bool32 PlayerWasTouchingEdge;
+};
@@ -0,0 +1,537 @@
+/*===============================================================
+ @Purpose: Streaming WAV playback
+ @Creator: Oyvind Andersson
+=================================================================*/
+
+#define RIFF_CODE(a, b, c, d) (((uint32)(a) << 0) | ((uint32)(b) << 8) | ((uint32)(c) << 16) | ((uint32)(d) << 24))
+
+enum
+{
+    WAVE_ChunkID_RIFF = RIFF_CODE( 'R', 'I', 'F', 'F' ),
+    WAVE_ChunkID_WAVE = RIFF_CODE( 'W', 'A', 'V', 'E' ),
+    WAVE_ChunkID_fmt  = RIFF_CODE( 'f', 'm', 't', ' ' ),
+    WAVE_ChunkID_data = RIFF_CODE( 'd', 'a', 't', 'a' ),
+};
+
+#define WAVE_FORMAT_TAG_PCM 0x0001
+#define WAVE_FORMAT_TAG_EXTENSIBLE 0xFFFE
+
+#pragma pack(push, 1)
+struct wave_header
+{
+    uint32 RIFFID;
+    uint32 Size;
+    uint32 WAVEID;
+};
+
+struct wave_chunk
+{
+    uint32 ID;
+    uint32 Size;
+};
+
+struct wave_fmt
+{
+    uint16 wFormatTag;
+    uint16 nChannels;
+    uint32 nSamplesPerSec;
+    uint32 nAvgBytesPerSec;
+    uint16 nBlockAlign;
+    uint16 wBitsPerSample;
+};
+#pragma pack(pop)
+
+//===============================================================
+// Format conversion
+// NOTE(oyvind): All of these write interleaved 16-bit stereo.
+// SSE2 does the bulk, the scalar loops only mop up the tail.
+//===============================================================
+
+INTERNAL void ConvertPCM16Stereo( uint8* Source, int16* Dest, uint32 FrameCount )
+{
+    uint32 FrameIndex = 0;
+    for ( ; FrameIndex + 4 <= FrameCount; FrameIndex += 4 )
+    {
+        _mm_storeu_si128( (__m128i*)Dest, _mm_loadu_si128( (__m128i*)Source ) );
+        Source += 16;
+        Dest += 8;
+    }
+
+    int16* SourceSample = (int16*)Source;
+    for ( ; FrameIndex < FrameCount; ++FrameIndex )
+    {
+        *Dest++ = *SourceSample++;
+        *Dest++ = *SourceSample++;
+    }
+}
+
+INTERNAL void ConvertPCM16Mono( uint8* Source, int16* Dest, uint32 FrameCount )
+{
+    uint32 FrameIndex = 0;
+    for ( ; FrameIndex + 8 <= FrameCount; FrameIndex += 8 )
+    {
+        __m128i Mono = _mm_loadu_si128( (__m128i*)Source );
+        _mm_storeu_si128( (__m128i*)Dest, _mm_unpacklo_epi16( Mono, Mono ) );
+        _mm_storeu_si128( (__m128i*)(Dest + 8), _mm_unpackhi_epi16( Mono, Mono ) );
+        Source += 16;
+        Dest += 16;
+    }
+
+    int16* SourceSample = (int16*)Source;
+    for ( ; FrameIndex < FrameCount; ++FrameIndex )
+    {
+        int16 Sample = *SourceSample++;
+        *Dest++ = Sample;
+        *Dest++ = Sample;
+    }
+}
+
+// NOTE(oyvind): 8-bit WAV is unsigned. Flipping the top bit makes it signed, and
+// unpacking it into the high byte of a zero word scales it up to 16 bits.
+INTERNAL void ConvertPCM8Stereo( uint8* Source, int16* Dest, uint32 FrameCount )
+{
+    __m128i Zero = _mm_setzero_si128();
+    __m128i SignFlip = _mm_set1_epi8( (char)0x80 );
+
+    uint32 FrameIndex = 0;
+    for ( ; FrameIndex + 8 <= FrameCount; FrameIndex += 8 )
+    {
+        __m128i Bytes = _mm_xor_si128( _mm_loadu_si128( (__m128i*)Source ), SignFlip );
+        _mm_storeu_si128( (__m128i*)Dest, _mm_unpacklo_epi8( Zero, Bytes ) );
+        _mm_storeu_si128( (__m128i*)(Dest + 8), _mm_unpackhi_epi8( Zero, Bytes ) );
+        Source += 16;
+        Dest += 16;
+    }
+
+    for ( ; FrameIndex < FrameCount; ++FrameIndex )
+    {
+        *Dest++ = (int16)(((int32)*Source++ - 128) << 8);
+        *Dest++ = (int16)(((int32)*Source++ - 128) << 8);
+    }
+}
+
+INTERNAL void ConvertPCM8Mono( uint8* Source, int16* Dest, uint32 FrameCount )
+{
+    __m128i Zero = _mm_setzero_si128();
+    __m128i SignFlip = _mm_set1_epi8( (char)0x80 );
+
+    uint32 FrameIndex = 0;
+    for ( ; FrameIndex + 16 <= FrameCount; FrameIndex += 16 )
+    {
+        __m128i Bytes = _mm_xor_si128( _mm_loadu_si128( (__m128i*)Source ), SignFlip );
+        __m128i Low = _mm_unpacklo_epi8( Zero, Bytes );
+        __m128i High = _mm_unpackhi_epi8( Zero, Bytes );
+        _mm_storeu_si128( (__m128i*)(Dest + 0), _mm_unpacklo_epi16( Low, Low ) );
+        _mm_storeu_si128( (__m128i*)(Dest + 8), _mm_unpackhi_epi16( Low, Low ) );
+        _mm_storeu_si128( (__m128i*)(Dest + 16), _mm_unpacklo_epi16( High, High ) );
+        _mm_storeu_si128( (__m128i*)(Dest + 24), _mm_unpackhi_epi16( High, High ) );
+        Source += 16;
+        Dest += 32;
+    }
+
+    for ( ; FrameIndex < FrameCount; ++FrameIndex )
+    {
+        int16 Sample = (int16)(((int32)*Source++ - 128) << 8);
+        *Dest++ = Sample;
+        *Dest++ = Sample;
+    }
+}
+
+// NOTE(oyvind): 24-bit just drops the low byte. Picking 2 bytes out of every 3
+// needs a byte shuffle (SSSE3), which we can not assume, so this stays scalar.
+INTERNAL void ConvertPCM24( uint8* Source, int16* Dest, uint32 FrameCount, uint32 ChannelCount )
+{
+    for ( uint32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex )
+    {
+        int16 Left = (int16)(Source[1] | (Source[2] << 8));
+        Source += 3;
+
+        int16 Right = Left;
+        if ( ChannelCount == 2 )
+        {
+            Right = (int16)(Source[1] | (Source[2] << 8));
+            Source += 3;
+        }
+
+        *Dest++ = Left;
+        *Dest++ = Right;
+    }
+}
+
+INTERNAL void ConvertWavFrames( wav_stream* Stream, uint8* Source, int16* Dest, uint32 FrameCount )
+{
+    if ( Stream->BitsPerSample == 16 )
+    {
+        if ( Stream->ChannelCount == 2 ) ConvertPCM16Stereo( Source, Dest, FrameCount );
+        else                             ConvertPCM16Mono( Source, Dest, FrameCount );
+    }
+    else if ( Stream->BitsPerSample == 8 )
+    {
+        if ( Stream->ChannelCount == 2 ) ConvertPCM8Stereo( Source, Dest, FrameCount );
+        else                             ConvertPCM8Mono( Source, Dest, FrameCount );
+    }
+    else
+    {
+        ConvertPCM24( Source, Dest, FrameCount, Stream->ChannelCount );
+    }
+}
+
+//===============================================================
+// Streaming
+//===============================================================
+
+INTERNAL bool32 OpenWavStream( wav_stream* Stream, platform_api* PlatformAPI, const char* FileName, bool32 Loop )
+{
+    *Stream = {};
+    Stream->Loop = Loop;
+
+    if ( !PlatformAPI->OpenMappedFile( FileName, &Stream->File ) )
+    {
+        // TODO(oyvind): Logging
+        return false;
+    }
+
+    platform_mapped_file* File = &Stream->File;
+    if ( File->Size >= sizeof( wave_header ) )
+    {
+        wave_header* Header = (wave_header*)PlatformAPI->MapFileWindow( File, 0, sizeof( wave_header ) );
+        if ( Header && (Header->RIFFID == WAVE_ChunkID_RIFF) && (Header->WAVEID == WAVE_ChunkID_WAVE) )
+        {
+            bool32 HasFormat = false;
+            uint64 ChunkOffset = sizeof( wave_header );
+            while ( ChunkOffset + sizeof( wave_chunk ) <= File->Size )
+            {
+                wave_chunk* ChunkHeader = (wave_chunk*)PlatformAPI->MapFileWindow( File, ChunkOffset, sizeof( wave_chunk ) );
+                if ( !ChunkHeader )
+                {
+                    break;
+                }
+
+                wave_chunk Chunk = *ChunkHeader;
+                uint64 ChunkDataOffset = ChunkOffset + sizeof( wave_chunk );
+
+                if ( (Chunk.ID == WAVE_ChunkID_fmt) && (Chunk.Size >= sizeof( wave_fmt )) &&
+                     (ChunkDataOffset + sizeof( wave_fmt ) <= File->Size) )
+                {
+                    wave_fmt* Format = (wave_fmt*)PlatformAPI->MapFileWindow( File, ChunkDataOffset, sizeof( wave_fmt ) );
+                    if ( Format &&
+                         ((Format->wFormatTag == WAVE_FORMAT_TAG_PCM) || (Format->wFormatTag == WAVE_FORMAT_TAG_EXTENSIBLE)) &&
+                         ((Format->nChannels == 1) || (Format->nChannels == 2)) &&
+                         ((Format->wBitsPerSample == 8) || (Format->wBitsPerSample == 16) || (Format->wBitsPerSample == 24)) &&
+                         (Format->nSamplesPerSec > 0) )
+                    {
+                        Stream->ChannelCount = Format->nChannels;
+                        Stream->BitsPerSample = Format->wBitsPerSample;
+                        Stream->BlockAlign = Format->nChannels * (Format->wBitsPerSample / 8);
+                        Stream->SamplesPerSecond = Format->nSamplesPerSec;
+                        HasFormat = true;
+                    }
+                }
+                else if ( (Chunk.ID == WAVE_ChunkID_data) && HasFormat )
+                {
+                    uint64 DataSize = Chunk.Size;
+                    if ( ChunkDataOffset + DataSize > File->Size )
+                    {
+                        // NOTE(oyvind): Truncated file, play what is there
+                        DataSize = File->Size - ChunkDataOffset;
+                    }
+
+                    Stream->DataOffset = ChunkDataOffset;
+                    Stream->FrameCount = DataSize / Stream->BlockAlign;
+                    Stream->IsValid = (Stream->FrameCount > 0);
+                    break;
+                }
+
+                // NOTE(oyvind): Chunks are padded to an even size
+                ChunkOffset = ChunkDataOffset + ((Chunk.Size + 1) & ~1u);
+            }
+        }
+    }
+
+    if ( !Stream->IsValid )
+    {
+        // TODO(oyvind): Logging, unsupported or broken file
+        PlatformAPI->CloseMappedFile( File );
+        return false;
+    }
+
+    Stream->Window = 0;
+    Stream->IsPlaying = true;
+    return true;
+}
+
+INTERNAL void CloseWavStream( wav_stream* Stream, platform_api* PlatformAPI )
+{
+    if ( Stream->IsValid )
+    {
+        PlatformAPI->CloseMappedFile( &Stream->File );
+    }
+    *Stream = {};
+}
+
+//===============================================================
+// @Purpose: Convert Count source frames starting at Frame into
+// Dest as 16-bit stereo, moving the mapped window along as
+// needed. Past the end we wrap when looping, else write silence.
+//===============================================================
+INTERNAL void ReadWavFrames( wav_stream* Stream, platform_api* PlatformAPI, uint64 Frame, uint32 Count, int16* Dest )
+{
+    while ( Count > 0 )
+    {
+        if ( Frame >= Stream->FrameCount )
+        {
+            if ( Stream->Loop )
+            {
+                Frame %= Stream->FrameCount;
+            }
+            else
+            {
+                for ( uint32 SampleIndex = 0; SampleIndex < Count * 2; ++SampleIndex )
+                {
+                    *Dest++ = 0;
+                }
+                return;
+            }
+        }
+
+        uint32 Frames = Count;
+        if ( Frames > Stream->FrameCount - Frame )
+        {
+            Frames = (uint32)(Stream->FrameCount - Frame);
+        }
+
+        uint64 ByteOffset = Stream->DataOffset + Frame * Stream->BlockAlign;
+        uint64 ByteEnd = ByteOffset + (uint64)Frames * Stream->BlockAlign;
+        if ( !Stream->Window || (ByteOffset < Stream->WindowOffset) || (ByteEnd > Stream->WindowOffset + Stream->WindowSize) )
+        {
+            uint64 DataEnd = Stream->DataOffset + Stream->FrameCount * Stream->BlockAlign;
+            uint64 WindowSize = DataEnd - ByteOffset;
+            if ( WindowSize > WAV_STREAM_WINDOW_SIZE )
+            {
+                // NOTE(oyvind): Whole frames only, so none straddle the window edge
+                WindowSize = WAV_STREAM_WINDOW_SIZE - (WAV_STREAM_WINDOW_SIZE % Stream->BlockAlign);
+            }
+
+            Stream->WindowOffset = ByteOffset;
+            Stream->WindowSize = (uint32)WindowSize;
+            Stream->Window = PlatformAPI->MapFileWindow( &Stream->File, ByteOffset, Stream->WindowSize );
+            if ( !Stream->Window )
+            {
+                // TODO(oyvind): Logging
+                Stream->IsPlaying = false;
+                for ( uint32 SampleIndex = 0; SampleIndex < Count * 2; ++SampleIndex )
+                {
+                    *Dest++ = 0;
+                }
+                return;
+            }
+        }
+
+        uint32 FramesInWindow = (uint32)((Stream->WindowOffset + Stream->WindowSize - ByteOffset) / Stream->BlockAlign);
+        if ( Frames > FramesInWindow )
+        {
+            Frames = FramesInWindow;
+        }
+
+        ConvertWavFrames( Stream, Stream->Window + (ByteOffset - Stream->WindowOffset), Dest, Frames );
+
+        Dest += Frames * 2;
+        Count -= Frames;
+        Frame += Frames;
+    }
+}
+
+INTERNAL int16 ClampSample( int32 Value )
+{
+    if ( Value > 32767 ) Value = 32767;
+    if ( Value < -32768 ) Value = -32768;
+    return (int16)Value;
+}
+
+//===============================================================
+// @Purpose: Mix the SoundBuffer->SampleCount output frames from
+// SoundBuffer->RunningSampleIndex on top of what is already in the
+// sound buffer.
+//===============================================================
+INTERNAL void MixWavStream( wav_stream* Stream, platform_api* PlatformAPI, gfs_sound_buffer* SoundBuffer, memory_arena* TransientArena )
+{
+    if ( !Stream->IsValid || !Stream->IsPlaying || (SoundBuffer->SampleCount <= 0) )
+    {
+        return;
+    }
+
+    BEGIN_TIMED_BLOCK( MixWavStream );
+
+    // NOTE(oyvind): 32.32 source frames per output frame. 16.16 drifts audibly over a long track.
+    uint64 Step = ((uint64)Stream->SamplesPerSecond << 32) / (uint64)SoundBuffer->SamplesPerSecond;
+    // NOTE(oyvind): A chunk reads from SourceFraction to SourceFraction + (CHUNK - 1) * Step, plus one
+    // frame for the interpolation. The fraction carried in can be almost a whole frame, which
+    // is one more frame than CHUNK * Step alone gives for rates like 8000 or 9600 Hz.
+    uint32 MaxSourceFrames = (uint32)(((uint64)0xFFFFFFFF + (uint64)(WAV_STREAM_CHUNK_FRAMES - 1) * Step) >> 32) + 2;
+    int16* Scratch = PushArray( TransientArena, MaxSourceFrames * 2, int16, MemoryTag_Sound );
+
+    if ( !Stream->IsStarted )
+    {
+        Stream->StartSampleIndex = SoundBuffer->RunningSampleIndex;
+        Stream->IsStarted = true;
+    }
+
+    // NOTE(oyvind): Position = OutputOffset * Step in 32.32, split so it cannot overflow 64 bits
+    // (good for 2^32 output samples, about a day at 48kHz).
+    Assert( SoundBuffer->RunningSampleIndex >= Stream->StartSampleIndex );
+    uint64 OutputOffset = SoundBuffer->RunningSampleIndex - Stream->StartSampleIndex;
+    uint64 FractionProduct = OutputOffset * (Step & 0xFFFFFFFF);
+    Stream->SourceFrame = OutputOffset * (Step >> 32) + (FractionProduct >> 32);
+    Stream->SourceFraction = (uint32)FractionProduct;
+    if ( Stream->SourceFrame >= Stream->FrameCount )
+    {
+        if ( Stream->Loop )
+        {
+            Stream->SourceFrame %= Stream->FrameCount;
+        }
+        else
+        {
+            Stream->IsPlaying = false;
+            END_TIMED_BLOCK( MixWavStream );
+            return;
+        }
+    }
+
+    int16* Out = SoundBuffer->Samples;
+    uint32 Remaining = (uint32)SoundBuffer->SampleCount;
+    while ( Remaining > 0 )
+    {
+        uint32 OutCount = (Remaining < WAV_STREAM_CHUNK_FRAMES) ? Remaining : WAV_STREAM_CHUNK_FRAMES;
+
+        if ( Step == ((uint64)1 << 32) )
+        {
+            ReadWavFrames( Stream, PlatformAPI, Stream->SourceFrame, OutCount, Scratch );
+
+            int16* In = Scratch;
+            uint32 SampleIndex = 0;
+            for ( ; SampleIndex + 8 <= OutCount * 2; SampleIndex += 8 )
+            {
+                __m128i Mixed = _mm_adds_epi16( _mm_loadu_si128( (__m128i*)(Out + SampleIndex) ),
+                                                _mm_loadu_si128( (__m128i*)(In + SampleIndex) ) );
+                _mm_storeu_si128( (__m128i*)(Out + SampleIndex), Mixed );
+            }
+            for ( ; SampleIndex < OutCount * 2; ++SampleIndex )
+            {
+                Out[SampleIndex] = ClampSample( (int32)Out[SampleIndex] + In[SampleIndex] );
+            }
+
+            Stream->SourceFrame += OutCount;
+        }
+        else
+        {
+            // NOTE(oyvind): Linear interpolation needs one frame past the last one we land on
+            uint32 SourceCount = (uint32)(((uint64)Stream->SourceFraction + (uint64)(OutCount - 1) * Step) >> 32) + 2;
+            Assert( SourceCount <= MaxSourceFrames );
+            ReadWavFrames( Stream, PlatformAPI, Stream->SourceFrame, SourceCount, Scratch );
+
+            uint64 Fraction = Stream->SourceFraction;
+            int16* Dest = Out;
+            for ( uint32 FrameIndex = 0; FrameIndex < OutCount; ++FrameIndex )
+            {
+                int16* A = Scratch + (Fraction >> 32) * 2;
+                int32 t = (int32)((Fraction >> 17) & 0x7FFF); // 1.15, keeps the multiply inside 32 bits
+
+                int32 Left = A[0] + (((A[2] - A[0]) * t) >> 15);
+                int32 Right = A[1] + (((A[3] - A[1]) * t) >> 15);
+                Dest[0] = ClampSample( Dest[0] + Left );
+                Dest[1] = ClampSample( Dest[1] + Right );
+                Dest += 2;
+
+                Fraction += Step;
+            }
+
+            Stream->SourceFrame += Fraction >> 32;
+            Stream->SourceFraction = (uint32)Fraction;
+        }
+
+        Out += OutCount * 2;
+        Remaining -= OutCount;
+    }
+
+    END_TIMED_BLOCK( MixWavStream );
+}
+
+//===============================================================
+// @Purpose: Queue a tone to start SecondsAfterFlip after this
+// frame is shown. Returns false when the queue is full.
+//
+// NOTE(oyvind): Samples before SoundBuffer->RunningSampleIndex
+// are already with the sound card. An event asked for there
+// starts on the first sample we still own. That is only a few
+// ms late when the card lets us write ahead of the flip; with a
+// long write-cursor lead it is late by about that lead.
+//===============================================================
+INTERNAL bool32 ScheduleSoundEvent( sound_event_queue* Queue, gfs_sound_buffer* SoundBuffer, real32 SecondsAfterFlip, real32 ToneHz, real32 DurationSeconds, real32 Volume )
+{
+    if ( Queue->Count >= MAX_SOUND_EVENT_COUNT )
+    {
+        return false;
+    }
+
+    int64 StartOffset = (int64)(SecondsAfterFlip * (real32)SoundBuffer->SamplesPerSecond);
+    uint64 StartSampleIndex = SoundBuffer->FlipSampleIndex + StartOffset;
+    if ( (StartOffset < 0) && ((uint64)-StartOffset > SoundBuffer->FlipSampleIndex) )
+    {
+        StartSampleIndex = 0;
+    }
+    if ( StartSampleIndex < SoundBuffer->RunningSampleIndex )
+    {
+        StartSampleIndex = SoundBuffer->RunningSampleIndex;
+    }
+
+    sound_event* Event = Queue->Events + Queue->Count++;
+    Event->StartSampleIndex = StartSampleIndex;
+    Event->SampleCount = (uint32)(DurationSeconds * (real32)SoundBuffer->SamplesPerSecond);
+    Event->ToneHz = ToneHz;
+    Event->Volume = Volume;
+
+    return true;
+}
+
+//===============================================================
+// @Purpose: Mix the part of every queued event that overlaps
+// this sound buffer. Phase and envelope come from the absolute
+// sample index, so a tone split across frames is seamless.
+//===============================================================
+INTERNAL void MixSoundEvents( sound_event_queue* Queue, gfs_sound_buffer* SoundBuffer )
+{
+    uint64 BufferStart = SoundBuffer->RunningSampleIndex;
+    uint64 BufferEnd = BufferStart + (uint64)SoundBuffer->SampleCount;
+
+    for ( uint32 EventIndex = 0; EventIndex < Queue->Count; )
+    {
+        sound_event* Event = Queue->Events + EventIndex;
+        uint64 EventEnd = Event->StartSampleIndex + Event->SampleCount;
+
+        uint64 First = (Event->StartSampleIndex > BufferStart) ? Event->StartSampleIndex : BufferStart;
+        uint64 OnePastLast = (EventEnd < BufferEnd) ? EventEnd : BufferEnd;
+
+        real32 PhaseStep = 2.0f * PI32 * Event->ToneHz / (real32)SoundBuffer->SamplesPerSecond;
+        real32 InvSampleCount = 1.0f / (real32)Event->SampleCount;
+        for ( uint64 SampleIndex = First; SampleIndex < OnePastLast; ++SampleIndex )
+        {
+            uint32 EventSample = (uint32)(SampleIndex - Event->StartSampleIndex);
+            real32 Envelope = 1.0f - (real32)EventSample * InvSampleCount;
+            int32 Value = (int32)(sinf( PhaseStep * (real32)EventSample ) * Event->Volume * Envelope);
+
+            int16* Out = SoundBuffer->Samples + (SampleIndex - BufferStart) * 2;
+            Out[0] = ClampSample( Out[0] + Value );
+            Out[1] = ClampSample( Out[1] + Value );
+        }
+
+        if ( EventEnd <= BufferEnd )
+        {
+            // NOTE(oyvind): Fully played, swap-remove
+            *Event = Queue->Events[--Queue->Count];
+        }
+        else
+        {
+            ++EventIndex;
+        }
+    }
+}
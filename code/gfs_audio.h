@@ -0,0 +1,75 @@
+#pragma once
+/*===============================================================
+ @Purpose: Streaming WAV playback
+ @Creator: Oyvind Andersson
+ @Notice : Tracks are never loaded whole. The file is memory
+           mapped one window at a time, and every frame we convert
+           just the source frames we need into 16-bit stereo,
+           resampling when the file rate is not the output rate.
+           Memory use is the window plus one chunk of scratch,
+           no matter how long the track is.
+=================================================================*/
+
+#define WAV_STREAM_WINDOW_SIZE Megabytes(1)
+#define WAV_STREAM_CHUNK_FRAMES 1024
+
+struct wav_stream
+{
+    bool32 IsValid;
+    bool32 IsPlaying;
+    bool32 Loop;
+
+    platform_mapped_file File;
+
+    // NOTE(oyvind): Source format, straight from the fmt chunk
+    uint32 ChannelCount;  // 1 or 2
+    uint32 BitsPerSample; // 8, 16 or 24
+    uint32 BlockAlign;
+    uint32 SamplesPerSecond;
+
+    uint64 DataOffset;
+    uint64 FrameCount;
+
+    // NOTE(oyvind): Output sample index that source frame 0 plays at, set on the first mix.
+    // The position is always derived from SoundBuffer->RunningSampleIndex, so when the
+    // platform skips ahead the music skips with the tone and the events instead of lagging.
+    bool32 IsStarted;
+    uint64 StartSampleIndex;
+
+    // NOTE(oyvind): Playback position in source frames as of the last mix, SourceFraction is the 0.32 fixed point part
+    uint64 SourceFrame;
+    uint32 SourceFraction;
+
+    // NOTE(oyvind): Currently mapped byte range of the file
+    uint8* Window;
+    uint64 WindowOffset;
+    uint32 WindowSize;
+};
+
+//===============================================================
+// Sound events
+// NOTE(oyvind): One-shot tones placed on an exact output sample.
+//===============================================================
+
+#define MAX_SOUND_EVENT_COUNT 32
+
+struct sound_event
+{
+    uint64 StartSampleIndex;
+    uint32 SampleCount;
+    real32 ToneHz;
+    real32 Volume; // Peak amplitude, decays linearly to 0
+};
+
+struct sound_event_queue
+{
+    uint32 Count;
+    sound_event Events[MAX_SOUND_EVENT_COUNT];
+};
+
+INTERNAL bool32 ScheduleSoundEvent( sound_event_queue* Queue, gfs_sound_buffer* SoundBuffer, real32 SecondsAfterFlip, real32 ToneHz, real32 DurationSeconds, real32 Volume );
+INTERNAL void MixSoundEvents( sound_event_queue* Queue, gfs_sound_buffer* SoundBuffer );
+
+INTERNAL bool32 OpenWavStream( wav_stream* Stream, platform_api* PlatformAPI, const char* FileName, bool32 Loop );
+INTERNAL void CloseWavStream( wav_stream* Stream, platform_api* PlatformAPI );
+INTERNAL void MixWavStream( wav_stream* Stream, platform_api* PlatformAPI, gfs_sound_buffer* SoundBuffer, memory_arena* TransientArena );
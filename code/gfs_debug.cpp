@@ -0,0 +1,189 @@
+/*===============================================================
+ @Purpose: Debug cycle counters and the on-screen performance HUD
+ @Creator: Oyvind Andersson
+=================================================================*/
+
+GLOBALVAR const char* DebugCycleCounterNames[DebugCycleCounter_Count] =
+{
+    "GameUpdateAndRender",
+    "OutputGameSound",
+    "MixWavStream",
+    "Render",
+    "UpdateParticles",
+    "RenderParticles",
+    "RenderGroupToOutput",
+    "DrawTriangles",
+    "DrawDebugHUD",
+    "PlatformSound",
+    "PlatformBlit",
+};
+
+#define HUD_X 8
+#define HUD_Y 8
+#define HUD_PADDING 6
+#define HUD_WIDTH 400
+#define HUD_GRAPH_HEIGHT 64
+#define HUD_GRAPH_BAR_WIDTH 3
+#define HUD_GRAPH_MAX_MS 33.333f
+#define HUD_TEXT_COLOR 0x00FFFFFF
+
+//===============================================================
+// @Purpose: Called by the platform once per frame, after the
+// frame timings are known. Snapshots the counters for the HUD.
+//===============================================================
+INTERNAL void DebugEndFrame( gfs_debug_state* DebugState, real32 MSPerFrame, real32 FPS, real32 MegaCyclesPerFrame )
+{
+    for ( int CounterIndex = 0; CounterIndex < DebugCycleCounter_Count; ++CounterIndex )
+    {
+        DebugState->LastCounters[CounterIndex] = DebugState->Counters[CounterIndex];
+        DebugState->Counters[CounterIndex].CycleCount = 0;
+        DebugState->Counters[CounterIndex].HitCount = 0;
+    }
+
+    DebugState->LastRenderStats = DebugState->RenderStats;
+    DebugState->RenderStats = {};
+
+    DebugState->LastMSPerFrame = MSPerFrame;
+    DebugState->LastFPS = FPS;
+    DebugState->LastMegaCyclesPerFrame = MegaCyclesPerFrame;
+
+    DebugState->FrameMS[DebugState->FrameHistoryIndex] = MSPerFrame;
+    DebugState->FrameHistoryIndex = (DebugState->FrameHistoryIndex + 1) % DEBUG_FRAME_HISTORY_COUNT;
+}
+
+//===============================================================
+// Helpers
+// NOTE(oyvind): Rects are clipped to the buffer, Max is exclusive
+//===============================================================
+
+INTERNAL bool32 DebugClipRect( gfs_offscreen_buffer* Buffer, int32* MinX, int32* MinY, int32* MaxX, int32* MaxY )
+{
+    if ( *MinX < 0 ) *MinX = 0;
+    if ( *MinY < 0 ) *MinY = 0;
+    if ( *MaxX > Buffer->Width ) *MaxX = Buffer->Width;
+    if ( *MaxY > Buffer->Height ) *MaxY = Buffer->Height;
+
+    return (*MinX < *MaxX) && (*MinY < *MaxY);
+}
+
+INTERNAL void DebugFillRect( gfs_offscreen_buffer* Buffer, int32 MinX, int32 MinY, int32 MaxX, int32 MaxY, uint32 Color )
+{
+    if ( DebugClipRect( Buffer, &MinX, &MinY, &MaxX, &MaxY ) )
+    {
+        uint8* Row = (uint8*)Buffer->Memory + MinY * Buffer->Pitch;
+        for ( int Y = MinY; Y < MaxY; ++Y )
+        {
+            uint32* Pixel = (uint32*)Row;
+            for ( int X = MinX; X < MaxX; ++X )
+            {
+                Pixel[X] = Color;
+            }
+            Row += Buffer->Pitch;
+        }
+    }
+}
+
+// NOTE(oyvind): Halves the brightness under the panel, 4 pixels at a time
+INTERNAL void DebugDarkenRect( gfs_offscreen_buffer* Buffer, int32 MinX, int32 MinY, int32 MaxX, int32 MaxY )
+{
+    if ( DebugClipRect( Buffer, &MinX, &MinY, &MaxX, &MaxY ) )
+    {
+        __m128i HalfMask4 = _mm_set1_epi32( 0x007F7F7F );
+        uint32 HalfMask = 0x007F7F7F;
+
+        uint8* Row = (uint8*)Buffer->Memory + MinY * Buffer->Pitch;
+        for ( int Y = MinY; Y < MaxY; ++Y )
+        {
+            uint32* Pixel = (uint32*)Row;
+            int X = MinX;
+            for ( ; X + 4 <= MaxX; X += 4 )
+            {
+                __m128i Value = _mm_loadu_si128( (__m128i*)(Pixel + X) );
+                Value = _mm_and_si128( _mm_srli_epi32( Value, 1 ), HalfMask4 );
+                _mm_storeu_si128( (__m128i*)(Pixel + X), Value );
+            }
+            for ( ; X < MaxX; ++X )
+            {
+                Pixel[X] = (Pixel[X] >> 1) & HalfMask;
+            }
+            Row += Buffer->Pitch;
+        }
+    }
+}
+
+//===============================================================
+// @Purpose: Draw the HUD panel with last frame's timings, the
+// frame-time graph and the per-counter costs.
+//===============================================================
+INTERNAL void DrawDebugHUD( gfs_debug_state* DebugState, gfs_offscreen_buffer* Buffer, font_atlas* Font )
+{
+    BEGIN_TIMED_BLOCK( DrawDebugHUD );
+
+    int32 LineHeight = Font->GlyphHeight + 2;
+    int32 TextLineCount = 2 + DebugCycleCounter_Count;
+    int32 PanelHeight = HUD_PADDING * 3 + HUD_GRAPH_HEIGHT + TextLineCount * LineHeight;
+
+    DebugDarkenRect( Buffer, HUD_X, HUD_Y, HUD_X + HUD_WIDTH, HUD_Y + PanelHeight );
+
+    int32 X = HUD_X + HUD_PADDING;
+    int32 Y = HUD_Y + HUD_PADDING;
+
+    char Line[128];
+    snprintf( Line, sizeof( Line ), "%.02fms/f %.01ff/s %.02fMcy/f",
+        DebugState->LastMSPerFrame, DebugState->LastFPS, DebugState->LastMegaCyclesPerFrame );
+    DrawString( Buffer, Font, X, Y, Line, HUD_TEXT_COLOR );
+    Y += LineHeight + HUD_PADDING;
+
+    //-------------------------------------------------------------------------------------------------
+    // NOTE(oyvind): Frame-time graph, oldest to the left. Reference lines at 16.6ms and 33.3ms.
+    //-------------------------------------------------------------------------------------------------
+    int32 GraphBottom = Y + HUD_GRAPH_HEIGHT;
+    real32 PixelsPerMS = (real32)HUD_GRAPH_HEIGHT / HUD_GRAPH_MAX_MS;
+
+    DebugFillRect( Buffer, X, GraphBottom - (int32)(16.667f * PixelsPerMS), X + DEBUG_FRAME_HISTORY_COUNT * HUD_GRAPH_BAR_WIDTH,
+        GraphBottom - (int32)(16.667f * PixelsPerMS) + 1, 0x00408040 );
+    DebugFillRect( Buffer, X, Y, X + DEBUG_FRAME_HISTORY_COUNT * HUD_GRAPH_BAR_WIDTH, Y + 1, 0x00804040 );
+
+    for ( int HistoryIndex = 0; HistoryIndex < DEBUG_FRAME_HISTORY_COUNT; ++HistoryIndex )
+    {
+        real32 MS = DebugState->FrameMS[(DebugState->FrameHistoryIndex + HistoryIndex) % DEBUG_FRAME_HISTORY_COUNT];
+        int32 BarHeight = (int32)(MS * PixelsPerMS);
+        if ( BarHeight > HUD_GRAPH_HEIGHT ) BarHeight = HUD_GRAPH_HEIGHT;
+
+        uint32 BarColor = 0x0000FF00;
+        if ( MS > 33.334f ) BarColor = 0x00FF0000;
+        else if ( MS > 16.667f ) BarColor = 0x00FFFF00;
+
+        int32 BarX = X + HistoryIndex * HUD_GRAPH_BAR_WIDTH;
+        DebugFillRect( Buffer, BarX, GraphBottom - BarHeight, BarX + HUD_GRAPH_BAR_WIDTH - 1, GraphBottom, BarColor );
+    }
+    Y = GraphBottom + HUD_PADDING;
+
+    //-------------------------------------------------------------------------------------------------
+    // NOTE(oyvind): Per-counter costs. Cycles are converted to ms using last frame's cycles/ms.
+    //-------------------------------------------------------------------------------------------------
+    real32 MSPerCycle = 0.0f;
+    if ( DebugState->LastMegaCyclesPerFrame > 0.0f )
+    {
+        MSPerCycle = DebugState->LastMSPerFrame / (DebugState->LastMegaCyclesPerFrame * 1000.0f * 1000.0f);
+    }
+
+    for ( int CounterIndex = 0; CounterIndex < DebugCycleCounter_Count; ++CounterIndex )
+    {
+        debug_cycle_counter* Counter = DebugState->LastCounters + CounterIndex;
+        snprintf( Line, sizeof( Line ), "%-20s%7.03fms %6.02fMcy %3ux",
+            DebugCycleCounterNames[CounterIndex],
+            (real32)Counter->CycleCount * MSPerCycle,
+            (real32)Counter->CycleCount / (1000.0f * 1000.0f),
+            Counter->HitCount );
+        DrawString( Buffer, Font, X, Y, Line, HUD_TEXT_COLOR );
+        Y += LineHeight;
+    }
+
+    debug_render_stats* RenderStats = &DebugState->LastRenderStats;
+    snprintf( Line, sizeof( Line ), "Render: %u drawn %u culled %u merged %u tris",
+        RenderStats->DrawnCount, RenderStats->CulledCount, RenderStats->MergedCount, RenderStats->TriangleCount );
+    DrawString( Buffer, Font, X, Y, Line, HUD_TEXT_COLOR );
+
+    END_TIMED_BLOCK( DrawDebugHUD );
+}
@@ -0,0 +1,76 @@
+#pragma once
+/*===============================================================
+ @Purpose: Debug cycle counters and the on-screen performance HUD
+ @Creator: Oyvind Andersson
+ @Notice : The platform owns the gfs_debug_state and feeds it the
+           frame timings at the end of every frame. Both layers
+           add to the cycle counters with TIMED_BLOCK markers, and
+           the game draws the previous frame's numbers on top of
+           the backbuffer when the HUD is toggled on (F2).
+=================================================================*/
+
+// NOTE(oyvind): Keep DebugCycleCounterNames in gfs_debug.cpp in sync
+enum debug_cycle_counter_id
+{
+    DebugCycleCounter_GameUpdateAndRender,
+    DebugCycleCounter_OutputGameSound,
+    DebugCycleCounter_MixWavStream,
+    DebugCycleCounter_Render,
+    DebugCycleCounter_UpdateParticles,
+    DebugCycleCounter_RenderParticles,
+    DebugCycleCounter_RenderGroupToOutput,
+    DebugCycleCounter_DrawTriangles,
+    DebugCycleCounter_DrawDebugHUD,
+    DebugCycleCounter_PlatformSound,
+    DebugCycleCounter_PlatformBlit,
+
+    DebugCycleCounter_Count
+};
+
+struct debug_cycle_counter
+{
+    uint64 CycleCount;
+    uint32 HitCount;
+};
+
+// NOTE(oyvind): Summed over every RenderGroupToOutput call in a frame
+struct debug_render_stats
+{
+    uint32 CulledCount;
+    uint32 MergedCount;
+    uint32 DrawnCount;
+    uint32 TriangleCount;
+};
+
+#define DEBUG_FRAME_HISTORY_COUNT 128
+
+struct gfs_debug_state
+{
+    bool32 ShowHUD;
+
+    debug_cycle_counter Counters[DebugCycleCounter_Count];     // Accumulating this frame
+    debug_cycle_counter LastCounters[DebugCycleCounter_Count]; // Completed last frame, what the HUD shows
+
+    debug_render_stats RenderStats;
+    debug_render_stats LastRenderStats;
+
+    real32 LastMSPerFrame;
+    real32 LastFPS;
+    real32 LastMegaCyclesPerFrame;
+
+    real32 FrameMS[DEBUG_FRAME_HISTORY_COUNT];
+    uint32 FrameHistoryIndex; // Next slot to write
+};
+
+GLOBALVAR gfs_debug_state* GlobalDebugState;
+
+#define BEGIN_TIMED_BLOCK(ID) uint64 StartCycleCount##ID = __rdtsc();
+#define END_TIMED_BLOCK(ID) \
+    if ( GlobalDebugState ) \
+    { \
+        GlobalDebugState->Counters[DebugCycleCounter_##ID].CycleCount += __rdtsc() - StartCycleCount##ID; \
+        ++GlobalDebugState->Counters[DebugCycleCounter_##ID].HitCount; \
+    }
+
+INTERNAL void DebugEndFrame( gfs_debug_state* DebugState, real32 MSPerFrame, real32 FPS, real32 MegaCyclesPerFrame );
+INTERNAL void DrawDebugHUD( gfs_debug_state* DebugState, gfs_offscreen_buffer* Buffer, font_atlas* Font );
@@ -0,0 +1,214 @@
+/*===============================================================
+ @Purpose: Software text rendering from a cached glyph atlas
+ @Creator: Oyvind Andersson
+=================================================================*/
+
+// NOTE(oyvind): Source glyphs are the public domain font8x8 basic set
+// (Daniel Hepper, from the IBM PC BIOS font). One byte per row, LSB is
+// the leftmost pixel. Covers FONT_FIRST_CODEPOINT..FONT_LAST_CODEPOINT.
+GLOBALVAR uint8 FontSourceGlyphs[FONT_GLYPH_COUNT][FONT_SOURCE_GLYPH_SIZE] =
+{
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // ' '
+    { 0x18, 0x3C, 0x3C, 0x18, 0x18, 0x00, 0x18, 0x00 }, // '!'
+    { 0x36, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // '"'
+    { 0x36, 0x36, 0x7F, 0x36, 0x7F, 0x36, 0x36, 0x00 }, // '#'
+    { 0x0C, 0x3E, 0x03, 0x1E, 0x30, 0x1F, 0x0C, 0x00 }, // '$'
+    { 0x00, 0x63, 0x33, 0x18, 0x0C, 0x66, 0x63, 0x00 }, // '%'
+    { 0x1C, 0x36, 0x1C, 0x6E, 0x3B, 0x33, 0x6E, 0x00 }, // '&'
+    { 0x06, 0x06, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 }, // '''
+    { 0x18, 0x0C, 0x06, 0x06, 0x06, 0x0C, 0x18, 0x00 }, // '('
+    { 0x06, 0x0C, 0x18, 0x18, 0x18, 0x0C, 0x06, 0x00 }, // ')'
+    { 0x00, 0x66, 0x3C, 0xFF, 0x3C, 0x66, 0x00, 0x00 }, // '*'
+    { 0x00, 0x0C, 0x0C, 0x3F, 0x0C, 0x0C, 0x00, 0x00 }, // '+'
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x06 }, // ','
+    { 0x00, 0x00, 0x00, 0x3F, 0x00, 0x00, 0x00, 0x00 }, // '-'
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x00 }, // '.'
+    { 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x00 }, // '/'
+    { 0x3E, 0x63, 0x73, 0x7B, 0x6F, 0x67, 0x3E, 0x00 }, // '0'
+    { 0x0C, 0x0E, 0x0C, 0x0C, 0x0C, 0x0C, 0x3F, 0x00 }, // '1'
+    { 0x1E, 0x33, 0x30, 0x1C, 0x06, 0x33, 0x3F, 0x00 }, // '2'
+    { 0x1E, 0x33, 0x30, 0x1C, 0x30, 0x33, 0x1E, 0x00 }, // '3'
+    { 0x38, 0x3C, 0x36, 0x33, 0x7F, 0x30, 0x78, 0x00 }, // '4'
+    { 0x3F, 0x03, 0x1F, 0x30, 0x30, 0x33, 0x1E, 0x00 }, // '5'
+    { 0x1C, 0x06, 0x03, 0x1F, 0x33, 0x33, 0x1E, 0x00 }, // '6'
+    { 0x3F, 0x33, 0x30, 0x18, 0x0C, 0x0C, 0x0C, 0x00 }, // '7'
+    { 0x1E, 0x33, 0x33, 0x1E, 0x33, 0x33, 0x1E, 0x00 }, // '8'
+    { 0x1E, 0x33, 0x33, 0x3E, 0x30, 0x18, 0x0E, 0x00 }, // '9'
+    { 0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, 0x00 }, // ':'
+    { 0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, 0x06 }, // ';'
+    { 0x18, 0x0C, 0x06, 0x03, 0x06, 0x0C, 0x18, 0x00 }, // '<'
+    { 0x00, 0x00, 0x3F, 0x00, 0x00, 0x3F, 0x00, 0x00 }, // '='
+    { 0x06, 0x0C, 0x18, 0x30, 0x18, 0x0C, 0x06, 0x00 }, // '>'
+    { 0x1E, 0x33, 0x30, 0x18, 0x0C, 0x00, 0x0C, 0x00 }, // '?'
+    { 0x3E, 0x63, 0x7B, 0x7B, 0x7B, 0x03, 0x1E, 0x00 }, // '@'
+    { 0x0C, 0x1E, 0x33, 0x33, 0x3F, 0x33, 0x33, 0x00 }, // 'A'
+    { 0x3F, 0x66, 0x66, 0x3E, 0x66, 0x66, 0x3F, 0x00 }, // 'B'
+    { 0x3C, 0x66, 0x03, 0x03, 0x03, 0x66, 0x3C, 0x00 }, // 'C'
+    { 0x1F, 0x36, 0x66, 0x66, 0x66, 0x36, 0x1F, 0x00 }, // 'D'
+    { 0x7F, 0x46, 0x16, 0x1E, 0x16, 0x46, 0x7F, 0x00 }, // 'E'
+    { 0x7F, 0x46, 0x16, 0x1E, 0x16, 0x06, 0x0F, 0x00 }, // 'F'
+    { 0x3C, 0x66, 0x03, 0x03, 0x73, 0x66, 0x7C, 0x00 }, // 'G'
+    { 0x33, 0x33, 0x33, 0x3F, 0x33, 0x33, 0x33, 0x00 }, // 'H'
+    { 0x1E, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00 }, // 'I'
+    { 0x78, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1E, 0x00 }, // 'J'
+    { 0x67, 0x66, 0x36, 0x1E, 0x36, 0x66, 0x67, 0x00 }, // 'K'
+    { 0x0F, 0x06, 0x06, 0x06, 0x46, 0x66, 0x7F, 0x00 }, // 'L'
+    { 0x63, 0x77, 0x7F, 0x7F, 0x6B, 0x63, 0x63, 0x00 }, // 'M'
+    { 0x63, 0x67, 0x6F, 0x7B, 0x73, 0x63, 0x63, 0x00 }, // 'N'
+    { 0x1C, 0x36, 0x63, 0x63, 0x63, 0x36, 0x1C, 0x00 }, // 'O'
+    { 0x3F, 0x66, 0x66, 0x3E, 0x06, 0x06, 0x0F, 0x00 }, // 'P'
+    { 0x1E, 0x33, 0x33, 0x33, 0x3B, 0x1E, 0x38, 0x00 }, // 'Q'
+    { 0x3F, 0x66, 0x66, 0x3E, 0x36, 0x66, 0x67, 0x00 }, // 'R'
+    { 0x1E, 0x33, 0x07, 0x0E, 0x38, 0x33, 0x1E, 0x00 }, // 'S'
+    { 0x3F, 0x2D, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00 }, // 'T'
+    { 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x3F, 0x00 }, // 'U'
+    { 0x33, 0x33, 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x00 }, // 'V'
+    { 0x63, 0x63, 0x63, 0x6B, 0x7F, 0x77, 0x63, 0x00 }, // 'W'
+    { 0x63, 0x63, 0x36, 0x1C, 0x1C, 0x36, 0x63, 0x00 }, // 'X'
+    { 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x0C, 0x1E, 0x00 }, // 'Y'
+    { 0x7F, 0x63, 0x31, 0x18, 0x4C, 0x66, 0x7F, 0x00 }, // 'Z'
+    { 0x1E, 0x06, 0x06, 0x06, 0x06, 0x06, 0x1E, 0x00 }, // '['
+    { 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x40, 0x00 }, // '\'
+    { 0x1E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x1E, 0x00 }, // ']'
+    { 0x08, 0x1C, 0x36, 0x63, 0x00, 0x00, 0x00, 0x00 }, // '^'
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF }, // '_'
+    { 0x0C, 0x0C, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00 }, // '`'
+    { 0x00, 0x00, 0x1E, 0x30, 0x3E, 0x33, 0x6E, 0x00 }, // 'a'
+    { 0x07, 0x06, 0x06, 0x3E, 0x66, 0x66, 0x3B, 0x00 }, // 'b'
+    { 0x00, 0x00, 0x1E, 0x33, 0x03, 0x33, 0x1E, 0x00 }, // 'c'
+    { 0x38, 0x30, 0x30, 0x3E, 0x33, 0x33, 0x6E, 0x00 }, // 'd'
+    { 0x00, 0x00, 0x1E, 0x33, 0x3F, 0x03, 0x1E, 0x00 }, // 'e'
+    { 0x1C, 0x36, 0x06, 0x0F, 0x06, 0x06, 0x0F, 0x00 }, // 'f'
+    { 0x00, 0x00, 0x6E, 0x33, 0x33, 0x3E, 0x30, 0x1F }, // 'g'
+    { 0x07, 0x06, 0x36, 0x6E, 0x66, 0x66, 0x67, 0x00 }, // 'h'
+    { 0x0C, 0x00, 0x0E, 0x0C, 0x0C, 0x0C, 0x1E, 0x00 }, // 'i'
+    { 0x30, 0x00, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1E }, // 'j'
+    { 0x07, 0x06, 0x66, 0x36, 0x1E, 0x36, 0x67, 0x00 }, // 'k'
+    { 0x0E, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00 }, // 'l'
+    { 0x00, 0x00, 0x33, 0x7F, 0x7F, 0x6B, 0x63, 0x00 }, // 'm'
+    { 0x00, 0x00, 0x1F, 0x33, 0x33, 0x33, 0x33, 0x00 }, // 'n'
+    { 0x00, 0x00, 0x1E, 0x33, 0x33, 0x33, 0x1E, 0x00 }, // 'o'
+    { 0x00, 0x00, 0x3B, 0x66, 0x66, 0x3E, 0x06, 0x0F }, // 'p'
+    { 0x00, 0x00, 0x6E, 0x33, 0x33, 0x3E, 0x30, 0x78 }, // 'q'
+    { 0x00, 0x00, 0x3B, 0x6E, 0x66, 0x06, 0x0F, 0x00 }, // 'r'
+    { 0x00, 0x00, 0x3E, 0x03, 0x1E, 0x30, 0x1F, 0x00 }, // 's'
+    { 0x08, 0x0C, 0x3E, 0x0C, 0x0C, 0x2C, 0x18, 0x00 }, // 't'
+    { 0x00, 0x00, 0x33, 0x33, 0x33, 0x33, 0x6E, 0x00 }, // 'u'
+    { 0x00, 0x00, 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x00 }, // 'v'
+    { 0x00, 0x00, 0x63, 0x6B, 0x7F, 0x7F, 0x36, 0x00 }, // 'w'
+    { 0x00, 0x00, 0x63, 0x36, 0x1C, 0x36, 0x63, 0x00 }, // 'x'
+    { 0x00, 0x00, 0x33, 0x33, 0x33, 0x3E, 0x30, 0x1F }, // 'y'
+    { 0x00, 0x00, 0x3F, 0x19, 0x0C, 0x26, 0x3F, 0x00 }, // 'z'
+    { 0x38, 0x0C, 0x0C, 0x07, 0x0C, 0x0C, 0x38, 0x00 }, // '{'
+    { 0x18, 0x18, 0x18, 0x00, 0x18, 0x18, 0x18, 0x00 }, // '|'
+    { 0x07, 0x0C, 0x0C, 0x38, 0x0C, 0x0C, 0x07, 0x00 }, // '}'
+    { 0x6E, 0x3B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // '~'
+};
+
+//===============================================================
+// @Purpose: Expand the 1-bit source glyphs into the mask atlas,
+// scaled up by Scale. Only ever done once, at startup.
+//===============================================================
+INTERNAL void InitializeFontAtlas( font_atlas* Atlas, memory_arena* Arena, int32 Scale )
+{
+    Assert( Scale > 0 );
+
+    Atlas->Scale = Scale;
+    Atlas->GlyphWidth = FONT_SOURCE_GLYPH_SIZE * Scale;
+    Atlas->GlyphHeight = FONT_SOURCE_GLYPH_SIZE * Scale;
+    Atlas->GlyphPixelCount = Atlas->GlyphWidth * Atlas->GlyphHeight;
+    Atlas->Masks = PushArray( Arena, FONT_GLYPH_COUNT * Atlas->GlyphPixelCount, uint32, MemoryTag_Debug );
+
+    uint32* Mask = Atlas->Masks;
+    for ( int GlyphIndex = 0; GlyphIndex < FONT_GLYPH_COUNT; ++GlyphIndex )
+    {
+        uint8* Source = FontSourceGlyphs[GlyphIndex];
+        for ( int Y = 0; Y < Atlas->GlyphHeight; ++Y )
+        {
+            uint8 SourceRow = Source[Y / Scale];
+            for ( int X = 0; X < Atlas->GlyphWidth; ++X )
+            {
+                *Mask++ = (SourceRow & (1 << (X / Scale))) ? 0xFFFFFFFF : 0;
+            }
+        }
+    }
+}
+
+//===============================================================
+// @Purpose: Blit String with its top-left corner at X,Y. Returns
+// the X where the next character would go. Glyphs fully inside
+// the buffer take the 4-wide SSE path; glyphs on the edge are
+// clipped per pixel.
+//===============================================================
+INTERNAL int32 DrawString( gfs_offscreen_buffer* Buffer, font_atlas* Atlas, int32 X, int32 Y, const char* String, uint32 Color )
+{
+    __m128i Color4 = _mm_set1_epi32( (int32)Color );
+    int32 GlyphWidth = Atlas->GlyphWidth;
+    int32 GlyphHeight = Atlas->GlyphHeight;
+
+    if ( (Y + GlyphHeight <= 0) || (Y >= Buffer->Height) )
+    {
+        // NOTE(oyvind): Entire line is off-screen, just advance
+        for ( const char* At = String; *At; ++At )
+        {
+            X += GlyphWidth;
+        }
+        return X;
+    }
+
+    for ( const char* At = String; *At; ++At, X += GlyphWidth )
+    {
+        int32 Codepoint = (uint8)*At;
+        if ( (Codepoint <= FONT_FIRST_CODEPOINT) || (Codepoint > FONT_LAST_CODEPOINT) )
+        {
+            // NOTE(oyvind): Space and anything we have no glyph for
+            continue;
+        }
+
+        if ( (X + GlyphWidth <= 0) || (X >= Buffer->Width) )
+        {
+            continue;
+        }
+
+        uint32* GlyphMask = Atlas->Masks + (Codepoint - FONT_FIRST_CODEPOINT) * Atlas->GlyphPixelCount;
+
+        if ( (X >= 0) && (Y >= 0) && (X + GlyphWidth <= Buffer->Width) && (Y + GlyphHeight <= Buffer->Height) )
+        {
+            uint8* Row = (uint8*)Buffer->Memory + Y * Buffer->Pitch + X * 4;
+            for ( int GlyphY = 0; GlyphY < GlyphHeight; ++GlyphY )
+            {
+                __m128i* Pixel = (__m128i*)Row;
+                __m128i* Mask = (__m128i*)GlyphMask;
+                for ( int GlyphX = 0; GlyphX < GlyphWidth; GlyphX += 4 )
+                {
+                    __m128i Dest = _mm_loadu_si128( Pixel );
+                    __m128i M = _mm_load_si128( Mask++ );
+                    Dest = _mm_or_si128( _mm_andnot_si128( M, Dest ), _mm_and_si128( M, Color4 ) );
+                    _mm_storeu_si128( Pixel++, Dest );
+                }
+
+                GlyphMask += GlyphWidth;
+                Row += Buffer->Pitch;
+            }
+        }
+        else
+        {
+            int32 MinX = (X < 0) ? -X : 0;
+            int32 MinY = (Y < 0) ? -Y : 0;
+            int32 MaxX = (X + GlyphWidth > Buffer->Width) ? (Buffer->Width - X) : GlyphWidth;
+            int32 MaxY = (Y + GlyphHeight > Buffer->Height) ? (Buffer->Height - Y) : GlyphHeight;
+
+            for ( int GlyphY = MinY; GlyphY < MaxY; ++GlyphY )
+            {
+                uint32* Pixel = (uint32*)((uint8*)Buffer->Memory + (Y + GlyphY) * Buffer->Pitch) + X;
+                uint32* Mask = GlyphMask + GlyphY * GlyphWidth;
+                for ( int GlyphX = MinX; GlyphX < MaxX; ++GlyphX )
+                {
+                    Pixel[GlyphX] = (Pixel[GlyphX] & ~Mask[GlyphX]) | (Color & Mask[GlyphX]);
+                }
+            }
+        }
+    }
+
+    return X;
+}
@@ -0,0 +1,28 @@
+#pragma once
+/*===============================================================
+ @Purpose: Software text rendering from a cached glyph atlas
+ @Creator: Oyvind Andersson
+ @Notice : Glyphs are rasterized exactly once, at startup, into
+           an atlas of per-pixel masks. Drawing a string is then
+           just a masked copy per glyph row, no bit twiddling and
+           no per-pixel branching in the hot loop.
+=================================================================*/
+
+#define FONT_FIRST_CODEPOINT 32
+#define FONT_LAST_CODEPOINT 126
+#define FONT_GLYPH_COUNT (FONT_LAST_CODEPOINT - FONT_FIRST_CODEPOINT + 1)
+#define FONT_SOURCE_GLYPH_SIZE 8
+
+struct font_atlas {
+    int32 Scale;
+    int32 GlyphWidth;  // NOTE(oyvind): Always a multiple of 4, so rows can be blitted 4 pixels at a time
+    int32 GlyphHeight;
+    int32 GlyphPixelCount;
+
+    // NOTE(oyvind): FONT_GLYPH_COUNT glyphs, each GlyphWidth*GlyphHeight
+    // masks of 0x00000000 or 0xFFFFFFFF, glyph-major and tightly packed.
+    uint32* Masks;
+};
+
+INTERNAL void InitializeFontAtlas( font_atlas* Atlas, memory_arena* Arena, int32 Scale );
+INTERNAL int32 DrawString( gfs_offscreen_buffer* Buffer, font_atlas* Atlas, int32 X, int32 Y, const char* String, uint32 Color );
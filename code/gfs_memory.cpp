@@ -0,0 +1,283 @@
+/*===============================================================
+ @Purpose: Memory accounting and arenas
+ @Creator: Oyvind Andersson
+=================================================================*/
+#include <stdio.h> // TODO(oyvind): Implement our own string formatting
+
+GLOBALVAR const char* MemoryTagNames[MemoryTag_Count] =
+{
+    "Unknown",
+    "Platform",
+    "BackBuffer",
+    "Sound",
+    "GamePermanent",
+    "GameTransient",
+    "GameState",
+    "Scratch",
+    "Debug",
+    "Particles",
+    "MappedFile",
+    "Render",
+};
+
+//===============================================================
+// Accounting
+//===============================================================
+
+INTERNAL void RecordBlockAllocated( gfs_memory_stats* Stats, memory_tag Tag, memory_index Size )
+{
+    Assert( Tag < MemoryTag_Count );
+    memory_tag_stats* TagStats = Stats->Tags + Tag;
+
+    TagStats->CommittedBytes += Size;
+    ++TagStats->BlockCount;
+    if ( TagStats->CommittedBytes > TagStats->CommittedPeakBytes )
+    {
+        TagStats->CommittedPeakBytes = TagStats->CommittedBytes;
+    }
+
+    Stats->CommittedBytes += Size;
+    if ( Stats->CommittedBytes > Stats->CommittedPeakBytes )
+    {
+        Stats->CommittedPeakBytes = Stats->CommittedBytes;
+    }
+}
+
+INTERNAL void RecordBlockFreed( gfs_memory_stats* Stats, memory_tag Tag, memory_index Size )
+{
+    Assert( Tag < MemoryTag_Count );
+    memory_tag_stats* TagStats = Stats->Tags + Tag;
+
+    Assert( TagStats->CommittedBytes >= Size );
+    Assert( TagStats->BlockCount > 0 );
+    TagStats->CommittedBytes -= Size;
+    --TagStats->BlockCount;
+
+    Stats->CommittedBytes -= Size;
+}
+
+// NOTE(oyvind): For one OS block shared by several tags. Record the whole block under
+// FromTag, then split the other parts off right away, before FromTag's peak means anything.
+INTERNAL void RecordBlockSplit( gfs_memory_stats* Stats, memory_tag FromTag, memory_tag ToTag, memory_index Size )
+{
+    Assert( (FromTag < MemoryTag_Count) && (ToTag < MemoryTag_Count) );
+    memory_tag_stats* From = Stats->Tags + FromTag;
+    memory_tag_stats* To = Stats->Tags + ToTag;
+
+    Assert( From->CommittedBytes >= Size );
+    if ( From->CommittedPeakBytes == From->CommittedBytes )
+    {
+        From->CommittedPeakBytes -= Size;
+    }
+    From->CommittedBytes -= Size;
+
+    To->CommittedBytes += Size;
+    ++To->BlockCount;
+    if ( To->CommittedBytes > To->CommittedPeakBytes )
+    {
+        To->CommittedPeakBytes = To->CommittedBytes;
+    }
+}
+
+// NOTE(oyvind): Call once at the top of every frame, before any transient arena is reset
+INTERNAL void BeginMemoryFrame( gfs_memory_stats* Stats )
+{
+    ++Stats->FrameIndex;
+    Stats->FrameBytes = 0;
+
+    for ( int TagIndex = 0; TagIndex < MemoryTag_Count; ++TagIndex )
+    {
+        Stats->Tags[TagIndex].FrameBytes = 0;
+    }
+}
+
+INTERNAL void RecordPush( gfs_memory_stats* Stats, memory_tag Tag, memory_index Size, bool32 IsTransient )
+{
+    Assert( Tag < MemoryTag_Count );
+    memory_tag_stats* TagStats = Stats->Tags + Tag;
+
+    ++TagStats->PushCount;
+    if ( IsTransient )
+    {
+        TagStats->FrameBytes += Size;
+        if ( TagStats->FrameBytes > TagStats->FramePeakBytes )
+        {
+            TagStats->FramePeakBytes = TagStats->FrameBytes;
+            TagStats->FramePeakIndex = Stats->FrameIndex;
+        }
+
+        Stats->FrameBytes += Size;
+        if ( Stats->FrameBytes > Stats->FramePeakBytes )
+        {
+            Stats->FramePeakBytes = Stats->FrameBytes;
+            Stats->FramePeakIndex = Stats->FrameIndex;
+        }
+    }
+    else
+    {
+        TagStats->UsedBytes += Size;
+        if ( TagStats->UsedBytes > TagStats->UsedPeakBytes )
+        {
+            TagStats->UsedPeakBytes = TagStats->UsedBytes;
+        }
+    }
+}
+
+//===============================================================
+// Arenas
+//===============================================================
+
+INTERNAL void InitializeArena( memory_arena* Arena, memory_index Size, void* Base, bool32 IsTransient, gfs_memory_stats* Stats, const char* Name )
+{
+    Arena->Size = Size;
+    Arena->Base = (uint8*)Base;
+    Arena->Used = 0;
+    Arena->PeakUsed = 0;
+    Arena->IsTransient = IsTransient;
+    Arena->Stats = Stats;
+
+    if ( Stats && Name )
+    {
+        Assert( Stats->ArenaCount < MAX_TRACKED_ARENA_COUNT );
+        if ( Stats->ArenaCount < MAX_TRACKED_ARENA_COUNT )
+        {
+            Stats->Arenas[Stats->ArenaCount] = Arena;
+            Stats->ArenaNames[Stats->ArenaCount] = Name;
+            ++Stats->ArenaCount;
+        }
+    }
+}
+
+INTERNAL void* PushSize_( memory_arena* Arena, memory_index Size, memory_tag Tag, memory_index Alignment )
+{
+    Assert( (Alignment & (Alignment - 1)) == 0 );
+
+    memory_index ResultPointer = (memory_index)Arena->Base + Arena->Used;
+    memory_index AlignmentOffset = 0;
+    memory_index AlignmentMask = Alignment - 1;
+    if ( ResultPointer & AlignmentMask )
+    {
+        AlignmentOffset = Alignment - (ResultPointer & AlignmentMask);
+    }
+
+    memory_index EffectiveSize = Size + AlignmentOffset;
+    Assert( (Arena->Used + EffectiveSize) <= Arena->Size );
+
+    void* Result = (void*)(ResultPointer + AlignmentOffset);
+    Arena->Used += EffectiveSize;
+    if ( Arena->Used > Arena->PeakUsed )
+    {
+        Arena->PeakUsed = Arena->Used;
+    }
+
+    if ( Arena->Stats )
+    {
+        RecordPush( Arena->Stats, Tag, EffectiveSize, Arena->IsTransient );
+    }
+
+    return Result;
+}
+
+// NOTE(oyvind): Only meant for transient arenas. PeakUsed is kept, the reports show it as the high-water mark.
+INTERNAL void ResetArena( memory_arena* Arena )
+{
+    Assert( Arena->IsTransient );
+    Arena->Used = 0;
+}
+
+//===============================================================
+// Reporting
+//===============================================================
+
+#define AppendReport(...) \
+    if ( Used < DestSize ) \
+    { \
+        int Written = snprintf( Dest + Used, DestSize - Used, __VA_ARGS__ ); \
+        if ( Written > 0 ) Used += Written; \
+        if ( Used >= DestSize ) { Used = DestSize - 1; Truncated = true; } \
+    }
+
+INTERNAL memory_index FormatMemoryReport( gfs_memory_stats* Stats, char* Dest, memory_index DestSize )
+{
+    memory_index Used = 0;
+    bool32 Truncated = false;
+
+    AppendReport( "=== Memory report (frame %llu) ===\n", Stats->FrameIndex );
+    AppendReport( "Committed: %llu KB (peak %llu KB)\n",
+        Stats->CommittedBytes / 1024, Stats->CommittedPeakBytes / 1024 );
+    AppendReport( "Transient: %llu KB this frame (peak %llu KB @ frame %llu)\n",
+        Stats->FrameBytes / 1024, Stats->FramePeakBytes / 1024, Stats->FramePeakIndex );
+    AppendReport( "%-14s %10s %10s %6s %10s %10s %10s %10s %8s\n",
+        "Tag", "Commit", "CommitPk", "Blocks", "Used", "UsedPk", "Frame", "FramePk", "PkFrame" );
+
+    for ( int TagIndex = 0; TagIndex < MemoryTag_Count; ++TagIndex )
+    {
+        memory_tag_stats* Tag = Stats->Tags + TagIndex;
+        if ( Tag->CommittedPeakBytes || Tag->PushCount )
+        {
+            AppendReport( "%-14s %10llu %10llu %6u %10llu %10llu %10llu %10llu %8llu\n",
+                MemoryTagNames[TagIndex],
+                Tag->CommittedBytes, Tag->CommittedPeakBytes, Tag->BlockCount,
+                Tag->UsedBytes, Tag->UsedPeakBytes,
+                Tag->FrameBytes, Tag->FramePeakBytes, Tag->FramePeakIndex );
+        }
+    }
+
+    if ( Stats->ArenaCount )
+    {
+        AppendReport( "%-14s %10s %10s %10s %6s\n", "Arena", "Size", "Used", "Peak", "Peak%" );
+        for ( uint32 ArenaIndex = 0; ArenaIndex < Stats->ArenaCount; ++ArenaIndex )
+        {
+            memory_arena* Arena = Stats->Arenas[ArenaIndex];
+            AppendReport( "%-14s %10llu %10llu %10llu %5.1f%%\n",
+                Stats->ArenaNames[ArenaIndex],
+                (uint64)Arena->Size, (uint64)Arena->Used, (uint64)Arena->PeakUsed,
+                Arena->Size ? (100.0 * (real64)Arena->PeakUsed / (real64)Arena->Size) : 0.0 );
+        }
+    }
+
+    return Truncated ? DestSize : Used;
+}
+
+INTERNAL memory_index FormatMemoryReportJSON( gfs_memory_stats* Stats, char* Dest, memory_index DestSize )
+{
+    memory_index Used = 0;
+    bool32 Truncated = false;
+
+    AppendReport( "{\n  \"frame\": %llu,\n", Stats->FrameIndex );
+    AppendReport( "  \"committed_bytes\": %llu,\n  \"committed_peak_bytes\": %llu,\n",
+        Stats->CommittedBytes, Stats->CommittedPeakBytes );
+    AppendReport( "  \"frame_bytes\": %llu,\n  \"frame_peak_bytes\": %llu,\n  \"frame_peak_index\": %llu,\n",
+        Stats->FrameBytes, Stats->FramePeakBytes, Stats->FramePeakIndex );
+    AppendReport( "  \"tags\": [\n" );
+
+    for ( int TagIndex = 0; TagIndex < MemoryTag_Count; ++TagIndex )
+    {
+        memory_tag_stats* Tag = Stats->Tags + TagIndex;
+        AppendReport( "    { \"tag\": \"%s\", \"committed_bytes\": %llu, \"committed_peak_bytes\": %llu, \"blocks\": %u, "
+            "\"used_bytes\": %llu, \"used_peak_bytes\": %llu, \"frame_bytes\": %llu, \"frame_peak_bytes\": %llu, "
+            "\"frame_peak_index\": %llu, \"pushes\": %llu }%s\n",
+            MemoryTagNames[TagIndex],
+            Tag->CommittedBytes, Tag->CommittedPeakBytes, Tag->BlockCount,
+            Tag->UsedBytes, Tag->UsedPeakBytes,
+            Tag->FrameBytes, Tag->FramePeakBytes, Tag->FramePeakIndex,
+            Tag->PushCount,
+            (TagIndex + 1 < MemoryTag_Count) ? "," : "" );
+    }
+
+    AppendReport( "  ],\n  \"arenas\": [\n" );
+    for ( uint32 ArenaIndex = 0; ArenaIndex < Stats->ArenaCount; ++ArenaIndex )
+    {
+        memory_arena* Arena = Stats->Arenas[ArenaIndex];
+        AppendReport( "    { \"arena\": \"%s\", \"size_bytes\": %llu, \"used_bytes\": %llu, \"peak_used_bytes\": %llu }%s\n",
+            Stats->ArenaNames[ArenaIndex],
+            (uint64)Arena->Size, (uint64)Arena->Used, (uint64)Arena->PeakUsed,
+            (ArenaIndex + 1 < Stats->ArenaCount) ? "," : "" );
+    }
+
+    AppendReport( "  ]\n}\n" );
+
+    return Truncated ? DestSize : Used;
+}
+
+#undef AppendReport
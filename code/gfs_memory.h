@@ -0,0 +1,114 @@
+#pragma once
+/*===============================================================
+ @Purpose: Memory accounting and arenas
+ @Creator: Oyvind Andersson
+ @Notice : Every byte we get from the OS, and every byte the game
+           carves out of those blocks, is tagged with the subsystem
+           that asked for it. We track current usage, lifetime
+           high-water marks and per-frame transient usage so that
+           memory budgets can be sized from real numbers.
+=================================================================*/
+
+//===============================================================
+// Tags
+//===============================================================
+
+// NOTE(oyvind): Keep MemoryTagNames in gfs_memory.cpp in sync
+enum memory_tag
+{
+    MemoryTag_Unknown,
+    MemoryTag_Platform,
+    MemoryTag_BackBuffer,
+    MemoryTag_Sound,
+    MemoryTag_GamePermanent,
+    MemoryTag_GameTransient,
+    MemoryTag_GameState,
+    MemoryTag_Scratch,
+    MemoryTag_Debug,
+    MemoryTag_Particles,
+    MemoryTag_MappedFile,
+    MemoryTag_Render,
+
+    MemoryTag_Count
+};
+
+//===============================================================
+// Stats
+//===============================================================
+
+struct memory_tag_stats
+{
+    // NOTE(oyvind): Blocks handed out by the OS (VirtualAlloc and friends)
+    uint64 CommittedBytes;
+    uint64 CommittedPeakBytes;
+    uint32 BlockCount;
+
+    // NOTE(oyvind): Lifetime pushes onto permanent arenas
+    uint64 UsedBytes;
+    uint64 UsedPeakBytes;
+
+    // NOTE(oyvind): Pushes onto transient arenas, reset every frame
+    uint64 FrameBytes;
+    uint64 FramePeakBytes;
+    uint64 FramePeakIndex; // Frame where FramePeakBytes last grew
+
+    uint64 PushCount;
+};
+
+#define MAX_TRACKED_ARENA_COUNT 8
+
+struct memory_arena;
+
+struct gfs_memory_stats
+{
+    memory_tag_stats Tags[MemoryTag_Count];
+
+    // NOTE(oyvind): Named arenas, so the reports can show how much of each block was
+    // ever used. The arenas must outlive the last report.
+    uint32 ArenaCount;
+    memory_arena* Arenas[MAX_TRACKED_ARENA_COUNT];
+    const char* ArenaNames[MAX_TRACKED_ARENA_COUNT];
+
+    uint64 CommittedBytes;
+    uint64 CommittedPeakBytes;
+    uint64 FrameBytes;
+    uint64 FramePeakBytes;
+    uint64 FramePeakIndex;
+
+    uint64 FrameIndex;
+};
+
+//===============================================================
+// Arenas
+//===============================================================
+
+struct memory_arena
+{
+    memory_index Size;
+    uint8* Base;
+    memory_index Used;
+    memory_index PeakUsed; // High-water mark, survives ResetArena. Reported for named arenas.
+
+    bool32 IsTransient;
+    gfs_memory_stats* Stats;
+};
+
+#define PushStruct(Arena, type, Tag) (type *)PushSize_(Arena, sizeof(type), Tag)
+#define PushArray(Arena, Count, type, Tag) (type *)PushSize_(Arena, (Count)*sizeof(type), Tag)
+#define PushSize(Arena, Size, Tag) PushSize_(Arena, Size, Tag)
+
+INTERNAL void RecordBlockAllocated( gfs_memory_stats* Stats, memory_tag Tag, memory_index Size );
+INTERNAL void RecordBlockFreed( gfs_memory_stats* Stats, memory_tag Tag, memory_index Size );
+INTERNAL void RecordBlockSplit( gfs_memory_stats* Stats, memory_tag FromTag, memory_tag ToTag, memory_index Size );
+INTERNAL void BeginMemoryFrame( gfs_memory_stats* Stats );
+
+INTERNAL void InitializeArena( memory_arena* Arena, memory_index Size, void* Base, bool32 IsTransient, gfs_memory_stats* Stats, const char* Name = 0 );
+INTERNAL void* PushSize_( memory_arena* Arena, memory_index Size, memory_tag Tag, memory_index Alignment = 16 );
+INTERNAL void ResetArena( memory_arena* Arena );
+
+// NOTE(oyvind): Worst case for either format, every counter at 20 digits. The formatters
+// return DestSize when the report did not fit, so truncation can't go unnoticed.
+#define MEMORY_REPORT_MAX_SIZE (1024 + MemoryTag_Count * 512 + MAX_TRACKED_ARENA_COUNT * 256)
+
+INTERNAL memory_index FormatMemoryReport( gfs_memory_stats* Stats, char* Dest, memory_index DestSize );
+INTERNAL memory_index FormatMemoryReportJSON( gfs_memory_stats* Stats, char* Dest, memory_index DestSize );
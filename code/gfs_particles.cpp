@@ -0,0 +1,195 @@
+/*===============================================================
+ @Purpose: Structure-of-arrays particle system
+ @Creator: Oyvind Andersson
+=================================================================*/
+
+// NOTE(oyvind): xorshift32, good enough for effects
+INTERNAL real32 ParticleRandomBilateral( particle_system* System )
+{
+    uint32 X = System->RandomState;
+    X ^= X << 13;
+    X ^= X >> 17;
+    X ^= X << 5;
+    System->RandomState = X;
+
+    return ((real32)(X >> 8) / (real32)(1 << 24)) * 2.0f - 1.0f;
+}
+
+INTERNAL void InitializeParticleSystem( particle_system* System, memory_arena* Arena, uint32 MaxCount )
+{
+    Assert( (MaxCount % PARTICLE_LANE_COUNT) == 0 );
+
+    System->MaxCount = MaxCount;
+    System->NextParticle = 0;
+    System->ActiveCount = 0;
+    System->GravityY = 300.0f;
+    System->Drag = 0.5f;
+    System->RandomState = 0x9E3779B9;
+
+    System->PX        = PushArray( Arena, MaxCount, real32, MemoryTag_Particles );
+    System->PY        = PushArray( Arena, MaxCount, real32, MemoryTag_Particles );
+    System->dPX       = PushArray( Arena, MaxCount, real32, MemoryTag_Particles );
+    System->dPY       = PushArray( Arena, MaxCount, real32, MemoryTag_Particles );
+    System->Life      = PushArray( Arena, MaxCount, real32, MemoryTag_Particles );
+    System->DecayRate = PushArray( Arena, MaxCount, real32, MemoryTag_Particles );
+    System->ColorR    = PushArray( Arena, MaxCount, real32, MemoryTag_Particles );
+    System->ColorG    = PushArray( Arena, MaxCount, real32, MemoryTag_Particles );
+    System->ColorB    = PushArray( Arena, MaxCount, real32, MemoryTag_Particles );
+}
+
+//===============================================================
+// @Purpose: Spawn Count particles at X,Y, spraying in random
+// directions at up to Speed px/s. Overwrites the oldest slots.
+//===============================================================
+INTERNAL void SpawnParticles( particle_system* System, uint32 Count, real32 X, real32 Y, real32 Speed, real32 Lifetime, uint32 Color )
+{
+    real32 R = (real32)((Color >> 16) & 0xFF);
+    real32 G = (real32)((Color >> 8) & 0xFF);
+    real32 B = (real32)((Color >> 0) & 0xFF);
+
+    for ( uint32 SpawnIndex = 0; SpawnIndex < Count; ++SpawnIndex )
+    {
+        uint32 Index = System->NextParticle++;
+        if ( System->NextParticle >= System->MaxCount )
+        {
+            System->NextParticle = 0;
+        }
+
+        System->PX[Index] = X;
+        System->PY[Index] = Y;
+        System->dPX[Index] = Speed * ParticleRandomBilateral( System );
+        System->dPY[Index] = Speed * (ParticleRandomBilateral( System ) - 0.5f);
+        System->Life[Index] = 1.0f;
+        System->DecayRate[Index] = 1.0f / (Lifetime * (1.0f + 0.25f * ParticleRandomBilateral( System )));
+        System->ColorR[Index] = R;
+        System->ColorG[Index] = G;
+        System->ColorB[Index] = B;
+
+        uint32 ActiveCount = (Index + PARTICLE_LANE_COUNT) & ~(PARTICLE_LANE_COUNT - 1);
+        if ( ActiveCount > System->ActiveCount )
+        {
+            System->ActiveCount = ActiveCount;
+        }
+    }
+}
+
+//===============================================================
+// @Purpose: Integrate particles [First, OnePastLast). Both must
+// be multiples of PARTICLE_LANE_COUNT. Ranges are independent,
+// so they can be handed out to worker threads as-is.
+//
+// NOTE(oyvind): 8 lanes are done as two SSE halves. SSE2 is the
+// baseline for x64, so this runs everywhere without /arch:AVX.
+//===============================================================
+INTERNAL void UpdateParticleRange( particle_system* System, uint32 First, uint32 OnePastLast, real32 dt )
+{
+    Assert( (First % PARTICLE_LANE_COUNT) == 0 );
+    Assert( (OnePastLast % PARTICLE_LANE_COUNT) == 0 );
+    Assert( OnePastLast <= System->MaxCount );
+
+    __m128 dt4 = _mm_set1_ps( dt );
+    __m128 GravityDelta4 = _mm_set1_ps( System->GravityY * dt );
+    __m128 DragFactor4 = _mm_set1_ps( 1.0f - System->Drag * dt );
+    __m128 Zero4 = _mm_setzero_ps();
+
+    for ( uint32 Index = First; Index < OnePastLast; Index += PARTICLE_LANE_COUNT )
+    {
+        for ( uint32 Lane = 0; Lane < PARTICLE_LANE_COUNT; Lane += 4 )
+        {
+            uint32 I = Index + Lane;
+
+            __m128 PX = _mm_load_ps( System->PX + I );
+            __m128 PY = _mm_load_ps( System->PY + I );
+            __m128 dPX = _mm_load_ps( System->dPX + I );
+            __m128 dPY = _mm_load_ps( System->dPY + I );
+            __m128 Life = _mm_load_ps( System->Life + I );
+            __m128 DecayRate = _mm_load_ps( System->DecayRate + I );
+
+            PX = _mm_add_ps( PX, _mm_mul_ps( dPX, dt4 ) );
+            PY = _mm_add_ps( PY, _mm_mul_ps( dPY, dt4 ) );
+            dPX = _mm_mul_ps( dPX, DragFactor4 );
+            dPY = _mm_mul_ps( _mm_add_ps( dPY, GravityDelta4 ), DragFactor4 );
+            Life = _mm_max_ps( _mm_sub_ps( Life, _mm_mul_ps( DecayRate, dt4 ) ), Zero4 );
+
+            _mm_store_ps( System->PX + I, PX );
+            _mm_store_ps( System->PY + I, PY );
+            _mm_store_ps( System->dPX + I, dPX );
+            _mm_store_ps( System->dPY + I, dPY );
+            _mm_store_ps( System->Life + I, Life );
+        }
+    }
+}
+
+INTERNAL void UpdateParticles( particle_system* System, real32 dt )
+{
+    BEGIN_TIMED_BLOCK( UpdateParticles );
+    UpdateParticleRange( System, 0, System->ActiveCount, dt );
+    END_TIMED_BLOCK( UpdateParticles );
+}
+
+//===============================================================
+// @Purpose: Additively splat every live particle as one pixel.
+// Pixel offsets and packed, faded colors are computed 8 lanes at
+// a time; dead or off-screen lanes get offset 0 and color 0, so
+// the scatter loop that follows has no branches at all.
+//===============================================================
+INTERNAL void RenderParticles( particle_system* System, gfs_offscreen_buffer* Buffer )
+{
+    BEGIN_TIMED_BLOCK( RenderParticles );
+
+    Assert( (Buffer->Pitch % 4) == 0 );
+    uint32* Pixels = (uint32*)Buffer->Memory;
+
+    __m128 Zero4 = _mm_setzero_ps();
+    __m128 Max4 = _mm_set1_ps( 255.0f );
+    __m128 Width4 = _mm_set1_ps( (real32)Buffer->Width );
+    __m128 Height4 = _mm_set1_ps( (real32)Buffer->Height );
+    __m128 PitchInPixels4 = _mm_set1_ps( (real32)(Buffer->Pitch / 4) );
+
+#if defined(_MSC_VER)
+    __declspec(align(16)) uint32 Offsets[PARTICLE_LANE_COUNT];
+    __declspec(align(16)) uint32 Colors[PARTICLE_LANE_COUNT];
+#else
+    uint32 Offsets[PARTICLE_LANE_COUNT] __attribute__((aligned(16)));
+    uint32 Colors[PARTICLE_LANE_COUNT] __attribute__((aligned(16)));
+#endif
+
+    for ( uint32 Index = 0; Index < System->ActiveCount; Index += PARTICLE_LANE_COUNT )
+    {
+        for ( uint32 Lane = 0; Lane < PARTICLE_LANE_COUNT; Lane += 4 )
+        {
+            uint32 I = Index + Lane;
+
+            __m128 PX = _mm_load_ps( System->PX + I );
+            __m128 PY = _mm_load_ps( System->PY + I );
+            __m128 Life = _mm_load_ps( System->Life + I );
+
+            __m128 Valid = _mm_and_ps( _mm_cmpgt_ps( Life, Zero4 ),
+                           _mm_and_ps( _mm_and_ps( _mm_cmpge_ps( PX, Zero4 ), _mm_cmplt_ps( PX, Width4 ) ),
+                                       _mm_and_ps( _mm_cmpge_ps( PY, Zero4 ), _mm_cmplt_ps( PY, Height4 ) ) ) );
+            __m128i ValidI = _mm_castps_si128( Valid );
+
+            // NOTE(oyvind): Truncate to whole pixels first, floats are exact for offsets up to 2^24
+            __m128 XWhole = _mm_cvtepi32_ps( _mm_cvttps_epi32( PX ) );
+            __m128 YWhole = _mm_cvtepi32_ps( _mm_cvttps_epi32( PY ) );
+            __m128i Offset = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( YWhole, PitchInPixels4 ), XWhole ) );
+
+            __m128i R = _mm_cvttps_epi32( _mm_min_ps( _mm_mul_ps( _mm_load_ps( System->ColorR + I ), Life ), Max4 ) );
+            __m128i G = _mm_cvttps_epi32( _mm_min_ps( _mm_mul_ps( _mm_load_ps( System->ColorG + I ), Life ), Max4 ) );
+            __m128i B = _mm_cvttps_epi32( _mm_min_ps( _mm_mul_ps( _mm_load_ps( System->ColorB + I ), Life ), Max4 ) );
+            __m128i Color = _mm_or_si128( _mm_or_si128( _mm_slli_epi32( R, 16 ), _mm_slli_epi32( G, 8 ) ), B );
+
+            _mm_store_si128( (__m128i*)(Offsets + Lane), _mm_and_si128( Offset, ValidI ) );
+            _mm_store_si128( (__m128i*)(Colors + Lane), _mm_and_si128( Color, ValidI ) );
+        }
+
+        for ( uint32 Lane = 0; Lane < PARTICLE_LANE_COUNT; ++Lane )
+        {
+            uint32* Pixel = Pixels + Offsets[Lane];
+            *Pixel = (uint32)_mm_cvtsi128_si32( _mm_adds_epu8( _mm_cvtsi32_si128( (int32)*Pixel ),
+                                                               _mm_cvtsi32_si128( (int32)Colors[Lane] ) ) );
+        }
+    }
+
+    END_TIMED_BLOCK( RenderParticles );
+}
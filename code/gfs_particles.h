@@ -0,0 +1,43 @@
+#pragma once
+/*===============================================================
+ @Purpose: Structure-of-arrays particle system
+ @Creator: Oyvind Andersson
+ @Notice : Every particle attribute is its own tightly packed
+           array, so the update touches only what it needs and
+           works on 8 particles per step with straight SIMD loads.
+           Particles live in a ring: spawning overwrites the
+           oldest slot, dead particles just have zero Life and
+           contribute nothing when splatted.
+=================================================================*/
+
+#define PARTICLE_LANE_COUNT 8
+#define MAX_PARTICLE_COUNT (128*1024) // NOTE(oyvind): Must be a multiple of PARTICLE_LANE_COUNT
+
+struct particle_system
+{
+    uint32 MaxCount;
+    uint32 NextParticle;
+    uint32 ActiveCount; // Rounded up to PARTICLE_LANE_COUNT, never shrinks
+
+    real32 GravityY;
+    real32 Drag;
+
+    // NOTE(oyvind): Each is MaxCount long
+    real32* PX;
+    real32* PY;
+    real32* dPX;
+    real32* dPY;
+    real32* Life;      // 1 at spawn, fades to 0
+    real32* DecayRate; // 1 / lifetime in seconds
+    real32* ColorR;    // 0..255, scaled by Life when splatted
+    real32* ColorG;
+    real32* ColorB;
+
+    uint32 RandomState;
+};
+
+INTERNAL void InitializeParticleSystem( particle_system* System, memory_arena* Arena, uint32 MaxCount );
+INTERNAL void SpawnParticles( particle_system* System, uint32 Count, real32 X, real32 Y, real32 Speed, real32 Lifetime, uint32 Color );
+INTERNAL void UpdateParticleRange( particle_system* System, uint32 First, uint32 OnePastLast, real32 dt );
+INTERNAL void UpdateParticles( particle_system* System, real32 dt );
+INTERNAL void RenderParticles( particle_system* System, gfs_offscreen_buffer* Buffer );
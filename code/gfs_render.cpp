@@ -0,0 +1,1002 @@
+/*===============================================================
+ @Purpose: Push-buffer renderer
+ @Creator: Oyvind Andersson
+=================================================================*/
+
+INTERNAL int32 RoundReal32ToInt32( real32 Value )
+{
+    return (int32)floorf( Value + 0.5f );
+}
+
+struct render_rect
+{
+    int32 MinX;
+    int32 MinY;
+    int32 MaxX;
+    int32 MaxY;
+};
+
+//===============================================================
+// Pushing
+//===============================================================
+
+INTERNAL render_group* AllocateRenderGroup( memory_arena* Arena, uint32 MaxPushBufferSize, uint32 MaxEntryCount )
+{
+    render_group* Group = PushStruct( Arena, render_group, MemoryTag_Render );
+
+    Group->MaxPushBufferSize = MaxPushBufferSize;
+    Group->PushBufferSize = 0;
+    Group->PushBufferBase = (uint8*)PushSize( Arena, MaxPushBufferSize, MemoryTag_Render );
+
+    Group->MaxEntryCount = MaxEntryCount;
+    Group->EntryCount = 0;
+    Group->SortEntries = PushArray( Arena, MaxEntryCount, render_sort_entry, MemoryTag_Render );
+    Group->SortTemp = PushArray( Arena, MaxEntryCount, render_sort_entry, MemoryTag_Render );
+    Group->ScratchArena = Arena;
+
+    Group->CulledCount = 0;
+    Group->MergedCount = 0;
+    Group->DrawnCount = 0;
+    Group->TriangleCount = 0;
+
+    return Group;
+}
+
+#define PushRenderEntry(Group, type, Type, Layer, Material) (type *)PushRenderEntry_( Group, sizeof(type), Type, Layer, Material )
+INTERNAL void* PushRenderEntry_( render_group* Group, uint32 Size, render_entry_type Type, uint16 Layer, uint16 Material )
+{
+    void* Result = 0;
+
+    uint32 EntrySize = (sizeof( render_entry_header ) + Size + 7) & ~7u;
+    if ( (Group->PushBufferSize + EntrySize <= Group->MaxPushBufferSize) && (Group->EntryCount < Group->MaxEntryCount) )
+    {
+        render_entry_header* Header = (render_entry_header*)(Group->PushBufferBase + Group->PushBufferSize);
+        Header->Type = (uint16)Type;
+        Header->Layer = Layer;
+        Header->PushIndex = Group->EntryCount;
+
+        render_sort_entry* SortEntry = Group->SortEntries + Group->EntryCount++;
+        SortEntry->SortKey = ((uint64)Layer << 48) | ((uint64)Material << 32) | (uint64)Header->PushIndex;
+        SortEntry->PushBufferOffset = Group->PushBufferSize;
+
+        Result = Header + 1;
+        Group->PushBufferSize += EntrySize;
+    }
+    else
+    {
+        // TODO(oyvind): Logging. Dropping draws beats overrunning the transient arena.
+        Assert( !"Render group is full" );
+    }
+
+    return Result;
+}
+
+// NOTE(oyvind): Materials group entries that use the same code path and
+// state. Type goes in the top bits; the rest is a cheap hash of the state.
+INTERNAL uint16 RenderMaterial( render_entry_type Type, uint32 StateHash )
+{
+    return (uint16)(((uint32)Type << 12) | ((StateHash ^ (StateHash >> 12) ^ (StateHash >> 24)) & 0x0FFF));
+}
+
+INTERNAL void PushClear( render_group* Group, uint32 Color )
+{
+    render_entry_clear* Entry = PushRenderEntry( Group, render_entry_clear, RenderEntry_Clear, 0, 0 );
+    if ( Entry )
+    {
+        Entry->Color = Color;
+    }
+}
+
+INTERNAL void PushRectangle( render_group* Group, uint16 Layer, real32 MinX, real32 MinY, real32 MaxX, real32 MaxY, uint32 Color )
+{
+    render_entry_rectangle* Entry = PushRenderEntry( Group, render_entry_rectangle, RenderEntry_Rectangle, Layer,
+        RenderMaterial( RenderEntry_Rectangle, Color ) );
+    if ( Entry )
+    {
+        Entry->MinX = MinX;
+        Entry->MinY = MinY;
+        Entry->MaxX = MaxX;
+        Entry->MaxY = MaxY;
+        Entry->Color = Color;
+    }
+}
+
+INTERNAL void PushBitmap( render_group* Group, uint16 Layer, loaded_bitmap* Bitmap, real32 X, real32 Y )
+{
+    render_entry_bitmap* Entry = PushRenderEntry( Group, render_entry_bitmap, RenderEntry_Bitmap, Layer,
+        RenderMaterial( RenderEntry_Bitmap, (uint32)((memory_index)Bitmap >> 4) ) );
+    if ( Entry )
+    {
+        Entry->Bitmap = Bitmap;
+        Entry->X = X;
+        Entry->Y = Y;
+    }
+}
+
+INTERNAL void PushTriangles( render_group* Group, uint16 Layer, loaded_bitmap* Texture, uint32 Color, render_vertex* Vertices, uint32 TriangleCount )
+{
+    uint32 VertexCount = 3 * TriangleCount;
+    render_entry_triangles* Entry = (render_entry_triangles*)PushRenderEntry_( Group,
+        sizeof( render_entry_triangles ) + VertexCount * sizeof( render_vertex ), RenderEntry_Triangles, Layer,
+        RenderMaterial( RenderEntry_Triangles, Texture ? (uint32)((memory_index)Texture >> 4) : Color ) );
+    if ( Entry )
+    {
+        Entry->Texture = Texture;
+        Entry->Color = Color;
+        Entry->TriangleCount = TriangleCount;
+
+        render_vertex* Dest = (render_vertex*)(Entry + 1);
+        for ( uint32 VertexIndex = 0; VertexIndex < VertexCount; ++VertexIndex )
+        {
+            Dest[VertexIndex] = Vertices[VertexIndex];
+        }
+    }
+}
+
+// NOTE(oyvind): Bitmap centered on (CenterX, CenterY), rotated by Angle radians (clockwise on screen)
+INTERNAL void PushSprite( render_group* Group, uint16 Layer, loaded_bitmap* Bitmap, real32 CenterX, real32 CenterY, real32 Angle, real32 Scale )
+{
+    real32 HalfWidth = 0.5f * Scale * (real32)Bitmap->Width;
+    real32 HalfHeight = 0.5f * Scale * (real32)Bitmap->Height;
+    real32 Cos = cosf( Angle );
+    real32 Sin = sinf( Angle );
+
+    real32 CornerX[4] = { -HalfWidth, HalfWidth, HalfWidth, -HalfWidth };
+    real32 CornerY[4] = { -HalfHeight, -HalfHeight, HalfHeight, HalfHeight };
+    real32 CornerU[4] = { 0.0f, 1.0f, 1.0f, 0.0f };
+    real32 CornerV[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+
+    render_vertex Corners[4];
+    for ( int CornerIndex = 0; CornerIndex < 4; ++CornerIndex )
+    {
+        Corners[CornerIndex].X = CenterX + Cos * CornerX[CornerIndex] - Sin * CornerY[CornerIndex];
+        Corners[CornerIndex].Y = CenterY + Sin * CornerX[CornerIndex] + Cos * CornerY[CornerIndex];
+        Corners[CornerIndex].U = CornerU[CornerIndex];
+        Corners[CornerIndex].V = CornerV[CornerIndex];
+    }
+
+    render_vertex Vertices[6] = { Corners[0], Corners[1], Corners[2], Corners[0], Corners[2], Corners[3] };
+    PushTriangles( Group, Layer, Bitmap, 0, Vertices, 2 );
+}
+
+//===============================================================
+// Sorting
+// NOTE(oyvind): Bottom-up merge sort. PushIndex is in the low
+// bits of the key, so keys are unique and the order is stable.
+//===============================================================
+
+INTERNAL void SortRenderEntries( render_group* Group )
+{
+    render_sort_entry* Source = Group->SortEntries;
+    render_sort_entry* Dest = Group->SortTemp;
+    uint32 Count = Group->EntryCount;
+
+    for ( uint32 Width = 1; Width < Count; Width *= 2 )
+    {
+        for ( uint32 Start = 0; Start < Count; Start += 2 * Width )
+        {
+            uint32 Mid = (Start + Width < Count) ? (Start + Width) : Count;
+            uint32 End = (Start + 2 * Width < Count) ? (Start + 2 * Width) : Count;
+
+            uint32 A = Start;
+            uint32 B = Mid;
+            uint32 Out = Start;
+            while ( (A < Mid) && (B < End) )
+            {
+                Dest[Out++] = (Source[A].SortKey <= Source[B].SortKey) ? Source[A++] : Source[B++];
+            }
+            while ( A < Mid ) Dest[Out++] = Source[A++];
+            while ( B < End ) Dest[Out++] = Source[B++];
+        }
+
+        render_sort_entry* Swap = Source;
+        Source = Dest;
+        Dest = Swap;
+    }
+
+    if ( Source != Group->SortEntries )
+    {
+        for ( uint32 Index = 0; Index < Count; ++Index )
+        {
+            Group->SortEntries[Index] = Source[Index];
+        }
+    }
+}
+
+//===============================================================
+// Culling and merging
+//===============================================================
+
+// NOTE(oyvind): Screen-space bounds in whole pixels, clipped to the buffer. Same rounding as the rasterizers.
+INTERNAL render_rect GetRenderEntryBounds( render_entry_header* Header, gfs_offscreen_buffer* Buffer )
+{
+    render_rect Result = { 0, 0, Buffer->Width, Buffer->Height };
+
+    if ( Header->Type == RenderEntry_Rectangle )
+    {
+        render_entry_rectangle* Entry = (render_entry_rectangle*)(Header + 1);
+        Result.MinX = RoundReal32ToInt32( Entry->MinX );
+        Result.MinY = RoundReal32ToInt32( Entry->MinY );
+        Result.MaxX = RoundReal32ToInt32( Entry->MaxX );
+        Result.MaxY = RoundReal32ToInt32( Entry->MaxY );
+    }
+    else if ( Header->Type == RenderEntry_Bitmap )
+    {
+        render_entry_bitmap* Entry = (render_entry_bitmap*)(Header + 1);
+        Result.MinX = RoundReal32ToInt32( Entry->X );
+        Result.MinY = RoundReal32ToInt32( Entry->Y );
+        Result.MaxX = Result.MinX + Entry->Bitmap->Width;
+        Result.MaxY = Result.MinY + Entry->Bitmap->Height;
+    }
+    else if ( Header->Type == RenderEntry_Triangles )
+    {
+        render_entry_triangles* Entry = (render_entry_triangles*)(Header + 1);
+        render_vertex* Vertices = (render_vertex*)(Entry + 1);
+
+        real32 MinX = RENDER_GUARD_BAND;
+        real32 MinY = RENDER_GUARD_BAND;
+        real32 MaxX = -RENDER_GUARD_BAND;
+        real32 MaxY = -RENDER_GUARD_BAND;
+        for ( uint32 VertexIndex = 0; VertexIndex < 3 * Entry->TriangleCount; ++VertexIndex )
+        {
+            if ( Vertices[VertexIndex].X < MinX ) MinX = Vertices[VertexIndex].X;
+            if ( Vertices[VertexIndex].Y < MinY ) MinY = Vertices[VertexIndex].Y;
+            if ( Vertices[VertexIndex].X > MaxX ) MaxX = Vertices[VertexIndex].X;
+            if ( Vertices[VertexIndex].Y > MaxY ) MaxY = Vertices[VertexIndex].Y;
+        }
+
+        Result.MinX = (int32)floorf( MinX );
+        Result.MinY = (int32)floorf( MinY );
+        Result.MaxX = (int32)ceilf( MaxX );
+        Result.MaxY = (int32)ceilf( MaxY );
+    }
+
+    if ( Result.MinX < 0 ) Result.MinX = 0;
+    if ( Result.MinY < 0 ) Result.MinY = 0;
+    if ( Result.MaxX > Buffer->Width ) Result.MaxX = Buffer->Width;
+    if ( Result.MaxY > Buffer->Height ) Result.MaxY = Buffer->Height;
+
+    return Result;
+}
+
+INTERNAL bool32 RenderRectIsEmpty( render_rect Rect )
+{
+    return (Rect.MinX >= Rect.MaxX) || (Rect.MinY >= Rect.MaxY);
+}
+
+INTERNAL bool32 RenderRectContains( render_rect Outer, render_rect Inner )
+{
+    return (Inner.MinX >= Outer.MinX) && (Inner.MinY >= Outer.MinY) &&
+           (Inner.MaxX <= Outer.MaxX) && (Inner.MaxY <= Outer.MaxY);
+}
+
+//===============================================================
+// @Purpose: Walk the sorted entries back to front. Anything off
+// screen, or fully under an opaque rectangle that is drawn later,
+// is culled. Only the largest few occluders are kept, which
+// catches the cases that matter (backgrounds, big panels) cheaply.
+//===============================================================
+INTERNAL void CullRenderEntries( render_group* Group, gfs_offscreen_buffer* Buffer )
+{
+    render_rect Occluders[RENDER_MAX_OCCLUDER_COUNT];
+    int64 OccluderAreas[RENDER_MAX_OCCLUDER_COUNT];
+    uint32 OccluderCount = 0;
+    bool32 ClearSeen = false;
+
+    for ( uint32 Index = Group->EntryCount; Index-- > 0; )
+    {
+        render_sort_entry* SortEntry = Group->SortEntries + Index;
+        render_entry_header* Header = (render_entry_header*)(Group->PushBufferBase + SortEntry->PushBufferOffset);
+
+        if ( ClearSeen )
+        {
+            SortEntry->PushBufferOffset = RENDER_ENTRY_CULLED;
+            ++Group->CulledCount;
+            continue;
+        }
+
+        if ( Header->Type == RenderEntry_Clear )
+        {
+            ClearSeen = true;
+            continue;
+        }
+
+        render_rect Bounds = GetRenderEntryBounds( Header, Buffer );
+        bool32 Culled = RenderRectIsEmpty( Bounds );
+        for ( uint32 OccluderIndex = 0; !Culled && (OccluderIndex < OccluderCount); ++OccluderIndex )
+        {
+            Culled = RenderRectContains( Occluders[OccluderIndex], Bounds );
+        }
+
+        if ( Culled )
+        {
+            SortEntry->PushBufferOffset = RENDER_ENTRY_CULLED;
+            ++Group->CulledCount;
+        }
+        else if ( Header->Type == RenderEntry_Rectangle )
+        {
+            int64 Area = (int64)(Bounds.MaxX - Bounds.MinX) * (int64)(Bounds.MaxY - Bounds.MinY);
+            if ( OccluderCount < RENDER_MAX_OCCLUDER_COUNT )
+            {
+                Occluders[OccluderCount] = Bounds;
+                OccluderAreas[OccluderCount] = Area;
+                ++OccluderCount;
+            }
+            else
+            {
+                uint32 Smallest = 0;
+                for ( uint32 OccluderIndex = 1; OccluderIndex < OccluderCount; ++OccluderIndex )
+                {
+                    if ( OccluderAreas[OccluderIndex] < OccluderAreas[Smallest] )
+                    {
+                        Smallest = OccluderIndex;
+                    }
+                }
+
+                if ( Area > OccluderAreas[Smallest] )
+                {
+                    Occluders[Smallest] = Bounds;
+                    OccluderAreas[Smallest] = Area;
+                }
+            }
+        }
+    }
+}
+
+// NOTE(oyvind): Same layer, same color and sharing a full edge means two rectangles are one
+INTERNAL void MergeRenderEntries( render_group* Group )
+{
+    render_entry_header* PrevHeader = 0;
+
+    for ( uint32 Index = 0; Index < Group->EntryCount; ++Index )
+    {
+        render_sort_entry* SortEntry = Group->SortEntries + Index;
+        if ( SortEntry->PushBufferOffset == RENDER_ENTRY_CULLED )
+        {
+            continue;
+        }
+
+        render_entry_header* Header = (render_entry_header*)(Group->PushBufferBase + SortEntry->PushBufferOffset);
+        if ( PrevHeader && (Header->Type == RenderEntry_Rectangle) && (PrevHeader->Type == RenderEntry_Rectangle) &&
+             (Header->Layer == PrevHeader->Layer) )
+        {
+            render_entry_rectangle* Prev = (render_entry_rectangle*)(PrevHeader + 1);
+            render_entry_rectangle* Rect = (render_entry_rectangle*)(Header + 1);
+
+            bool32 Merged = false;
+            if ( Prev->Color == Rect->Color )
+            {
+                if ( (Prev->MinY == Rect->MinY) && (Prev->MaxY == Rect->MaxY) )
+                {
+                    if ( Prev->MaxX == Rect->MinX ) { Prev->MaxX = Rect->MaxX; Merged = true; }
+                    else if ( Rect->MaxX == Prev->MinX ) { Prev->MinX = Rect->MinX; Merged = true; }
+                }
+                else if ( (Prev->MinX == Rect->MinX) && (Prev->MaxX == Rect->MaxX) )
+                {
+                    if ( Prev->MaxY == Rect->MinY ) { Prev->MaxY = Rect->MaxY; Merged = true; }
+                    else if ( Rect->MaxY == Prev->MinY ) { Prev->MinY = Rect->MinY; Merged = true; }
+                }
+            }
+
+            if ( Merged )
+            {
+                SortEntry->PushBufferOffset = RENDER_ENTRY_CULLED;
+                ++Group->MergedCount;
+                continue;
+            }
+        }
+
+        PrevHeader = Header;
+    }
+}
+
+//===============================================================
+// Rasterization
+//===============================================================
+
+INTERNAL void DrawRectangle( gfs_offscreen_buffer* Buffer, render_rect Rect, uint32 Color )
+{
+    __m128i Color4 = _mm_set1_epi32( (int32)Color );
+
+    uint8* Row = (uint8*)Buffer->Memory + Rect.MinY * Buffer->Pitch;
+    for ( int Y = Rect.MinY; Y < Rect.MaxY; ++Y )
+    {
+        uint32* Pixel = (uint32*)Row;
+        int X = Rect.MinX;
+        for ( ; X + 4 <= Rect.MaxX; X += 4 )
+        {
+            _mm_storeu_si128( (__m128i*)(Pixel + X), Color4 );
+        }
+        for ( ; X < Rect.MaxX; ++X )
+        {
+            Pixel[X] = Color;
+        }
+        Row += Buffer->Pitch;
+    }
+}
+
+// NOTE(oyvind): Clip is the already clipped destination rect, the source offset follows from it
+INTERNAL void DrawBitmap( gfs_offscreen_buffer* Buffer, render_rect Clip, loaded_bitmap* Bitmap, int32 X, int32 Y )
+{
+    uint8* SourceRow = (uint8*)Bitmap->Memory + (Clip.MinY - Y) * Bitmap->Pitch + (Clip.MinX - X) * 4;
+    uint8* DestRow = (uint8*)Buffer->Memory + Clip.MinY * Buffer->Pitch + Clip.MinX * 4;
+
+    for ( int DestY = Clip.MinY; DestY < Clip.MaxY; ++DestY )
+    {
+        uint32* Source = (uint32*)SourceRow;
+        uint32* Dest = (uint32*)DestRow;
+        for ( int DestX = Clip.MinX; DestX < Clip.MaxX; ++DestX )
+        {
+            uint32 S = *Source++;
+            uint32 A = S >> 24;
+            if ( A == 255 )
+            {
+                *Dest = S & 0x00FFFFFF;
+            }
+            else if ( A )
+            {
+                uint32 D = *Dest;
+                uint32 InvA = 255 - A;
+                uint32 R = (((S >> 16) & 0xFF) * A + ((D >> 16) & 0xFF) * InvA) / 255;
+                uint32 G = (((S >> 8) & 0xFF) * A + ((D >> 8) & 0xFF) * InvA) / 255;
+                uint32 B = (((S >> 0) & 0xFF) * A + ((D >> 0) & 0xFF) * InvA) / 255;
+                *Dest = (R << 16) | (G << 8) | B;
+            }
+            ++Dest;
+        }
+
+        SourceRow += Bitmap->Pitch;
+        DestRow += Buffer->Pitch;
+    }
+}
+
+//===============================================================
+// Triangles
+// NOTE(oyvind): Half-space rasterizer. Vertices are snapped to
+// 1/RENDER_SUBPIXEL_ONE of a pixel and every edge is an integer
+// function E = A*x + B*y + C that is >= 0 inside, with the
+// top-left fill rule folded into C. Two triangles sharing an
+// edge therefore never both touch, nor both miss, a pixel.
+//===============================================================
+
+struct render_triangle
+{
+    render_rect Bounds; // Pixels whose center can be inside, clipped
+
+    // NOTE(oyvind): In subpixels, bias for the fill rule already in EdgeC
+    int64 EdgeA[3];
+    int64 EdgeB[3];
+    int64 EdgeC[3];
+
+    // NOTE(oyvind): Texel coordinates as planes over pixel indices, T = T0 + dX*x + dY*y
+    real32 TexelX0;
+    real32 TexelXdX;
+    real32 TexelXdY;
+    real32 TexelY0;
+    real32 TexelYdX;
+    real32 TexelYdY;
+};
+
+INTERNAL bool32 SetupTriangle( render_triangle* Triangle, render_vertex* Vertices, render_rect Clip, loaded_bitmap* Texture )
+{
+    render_vertex* V0 = Vertices + 0;
+    render_vertex* V1 = Vertices + 1;
+    render_vertex* V2 = Vertices + 2;
+
+    for ( int VertexIndex = 0; VertexIndex < 3; ++VertexIndex )
+    {
+        // TODO(oyvind): Clip against the guard band instead of dropping the triangle
+        if ( (fabsf( Vertices[VertexIndex].X ) > RENDER_GUARD_BAND) || (fabsf( Vertices[VertexIndex].Y ) > RENDER_GUARD_BAND) )
+        {
+            return false;
+        }
+    }
+
+    int64 X0 = RoundReal32ToInt32( V0->X * RENDER_SUBPIXEL_ONE );
+    int64 Y0 = RoundReal32ToInt32( V0->Y * RENDER_SUBPIXEL_ONE );
+    int64 X1 = RoundReal32ToInt32( V1->X * RENDER_SUBPIXEL_ONE );
+    int64 Y1 = RoundReal32ToInt32( V1->Y * RENDER_SUBPIXEL_ONE );
+    int64 X2 = RoundReal32ToInt32( V2->X * RENDER_SUBPIXEL_ONE );
+    int64 Y2 = RoundReal32ToInt32( V2->Y * RENDER_SUBPIXEL_ONE );
+
+    int64 Area = (X1 - X0) * (Y2 - Y0) - (X2 - X0) * (Y1 - Y0);
+    if ( Area == 0 )
+    {
+        return false;
+    }
+    if ( Area < 0 )
+    {
+        // NOTE(oyvind): Make it counter-clockwise in math terms, so inside is E >= 0 for every edge
+        render_vertex* SwapVertex = V1; V1 = V2; V2 = SwapVertex;
+        int64 Swap = X1; X1 = X2; X2 = Swap;
+        Swap = Y1; Y1 = Y2; Y2 = Swap;
+        Area = -Area;
+    }
+
+    int64 MinX = X0 < X1 ? (X0 < X2 ? X0 : X2) : (X1 < X2 ? X1 : X2);
+    int64 MinY = Y0 < Y1 ? (Y0 < Y2 ? Y0 : Y2) : (Y1 < Y2 ? Y1 : Y2);
+    int64 MaxX = X0 > X1 ? (X0 > X2 ? X0 : X2) : (X1 > X2 ? X1 : X2);
+    int64 MaxY = Y0 > Y1 ? (Y0 > Y2 ? Y0 : Y2) : (Y1 > Y2 ? Y1 : Y2);
+
+    // NOTE(oyvind): Pixel x has its center at x*ONE + ONE/2
+    int64 HalfPixel = RENDER_SUBPIXEL_ONE / 2;
+    Triangle->Bounds.MinX = (int32)((MinX - HalfPixel) >> RENDER_SUBPIXEL_BITS);
+    Triangle->Bounds.MinY = (int32)((MinY - HalfPixel) >> RENDER_SUBPIXEL_BITS);
+    Triangle->Bounds.MaxX = (int32)((MaxX - HalfPixel) >> RENDER_SUBPIXEL_BITS) + 1;
+    Triangle->Bounds.MaxY = (int32)((MaxY - HalfPixel) >> RENDER_SUBPIXEL_BITS) + 1;
+    if ( Triangle->Bounds.MinX < Clip.MinX ) Triangle->Bounds.MinX = Clip.MinX;
+    if ( Triangle->Bounds.MinY < Clip.MinY ) Triangle->Bounds.MinY = Clip.MinY;
+    if ( Triangle->Bounds.MaxX > Clip.MaxX ) Triangle->Bounds.MaxX = Clip.MaxX;
+    if ( Triangle->Bounds.MaxY > Clip.MaxY ) Triangle->Bounds.MaxY = Clip.MaxY;
+    if ( RenderRectIsEmpty( Triangle->Bounds ) )
+    {
+        return false;
+    }
+
+    int64 EdgeX[3] = { X0, X1, X2 };
+    int64 EdgeY[3] = { Y0, Y1, Y2 };
+    for ( int EdgeIndex = 0; EdgeIndex < 3; ++EdgeIndex )
+    {
+        // NOTE(oyvind): Edge from vertex i to i+1, the opposite vertex is on the positive side
+        int64 AX = EdgeX[EdgeIndex];
+        int64 AY = EdgeY[EdgeIndex];
+        int64 BX = EdgeX[(EdgeIndex + 1) % 3];
+        int64 BY = EdgeY[(EdgeIndex + 1) % 3];
+
+        int64 A = AY - BY;
+        int64 B = BX - AX;
+        int64 C = AX * BY - AY * BX;
+
+        // NOTE(oyvind): Y points down, so inside is below a top edge (A == 0, B > 0) and
+        // right of a left edge (A > 0). Pixel centers exactly on any other edge are out.
+        bool32 IsTopLeft = (A > 0) || ((A == 0) && (B > 0));
+        if ( !IsTopLeft )
+        {
+            C -= 1;
+        }
+
+        Triangle->EdgeA[EdgeIndex] = A;
+        Triangle->EdgeB[EdgeIndex] = B;
+        Triangle->EdgeC[EdgeIndex] = C;
+    }
+
+    if ( Texture )
+    {
+        // NOTE(oyvind): Texel centers are at +0.5, so texel = U*Width - 0.5 maps an
+        // unrotated, unscaled sprite on whole pixels exactly onto its texels.
+        real64 PX0 = (real64)X0 / RENDER_SUBPIXEL_ONE;
+        real64 PY0 = (real64)Y0 / RENDER_SUBPIXEL_ONE;
+        real64 DX1 = (real64)(X1 - X0) / RENDER_SUBPIXEL_ONE;
+        real64 DY1 = (real64)(Y1 - Y0) / RENDER_SUBPIXEL_ONE;
+        real64 DX2 = (real64)(X2 - X0) / RENDER_SUBPIXEL_ONE;
+        real64 DY2 = (real64)(Y2 - Y0) / RENDER_SUBPIXEL_ONE;
+        real64 InvDet = 1.0 / (DX1 * DY2 - DX2 * DY1);
+
+        real64 TX0 = (real64)V0->U * Texture->Width - 0.5;
+        real64 TX1 = (real64)V1->U * Texture->Width - 0.5;
+        real64 TX2 = (real64)V2->U * Texture->Width - 0.5;
+        real64 TY0 = (real64)V0->V * Texture->Height - 0.5;
+        real64 TY1 = (real64)V1->V * Texture->Height - 0.5;
+        real64 TY2 = (real64)V2->V * Texture->Height - 0.5;
+
+        real64 TXdX = ((TX1 - TX0) * DY2 - (TX2 - TX0) * DY1) * InvDet;
+        real64 TXdY = ((TX2 - TX0) * DX1 - (TX1 - TX0) * DX2) * InvDet;
+        real64 TYdX = ((TY1 - TY0) * DY2 - (TY2 - TY0) * DY1) * InvDet;
+        real64 TYdY = ((TY2 - TY0) * DX1 - (TY1 - TY0) * DX2) * InvDet;
+
+        Triangle->TexelXdX = (real32)TXdX;
+        Triangle->TexelXdY = (real32)TXdY;
+        Triangle->TexelX0 = (real32)(TX0 + TXdX * (0.5 - PX0) + TXdY * (0.5 - PY0));
+        Triangle->TexelYdX = (real32)TYdX;
+        Triangle->TexelYdY = (real32)TYdY;
+        Triangle->TexelY0 = (real32)(TY0 + TYdX * (0.5 - PX0) + TYdY * (0.5 - PY0));
+    }
+
+    return true;
+}
+
+#define UnpackChannel(Pixels, Shift) _mm_cvtepi32_ps( _mm_and_si128( _mm_srli_epi32( Pixels, Shift ), MaskFF ) )
+
+// NOTE(oyvind): Four pixels at once. Texels are premultiplied before filtering, so
+// transparent texels do not bleed their color into the edges.
+INTERNAL __m128i ShadeBilinear4( loaded_bitmap* Texture, __m128 TexelX, __m128 TexelY, __m128i Dest )
+{
+    __m128i MaskFF = _mm_set1_epi32( 0xFF );
+    __m128 Zero = _mm_setzero_ps();
+    __m128 One = _mm_set1_ps( 1.0f );
+    __m128 Inv255 = _mm_set1_ps( 1.0f / 255.0f );
+
+    TexelX = _mm_min_ps( _mm_max_ps( TexelX, Zero ), _mm_set1_ps( (real32)(Texture->Width - 1) ) );
+    TexelY = _mm_min_ps( _mm_max_ps( TexelY, Zero ), _mm_set1_ps( (real32)(Texture->Height - 1) ) );
+
+    __m128i FetchX0 = _mm_cvttps_epi32( TexelX );
+    __m128i FetchY0 = _mm_cvttps_epi32( TexelY );
+    __m128 FracX = _mm_sub_ps( TexelX, _mm_cvtepi32_ps( FetchX0 ) );
+    __m128 FracY = _mm_sub_ps( TexelY, _mm_cvtepi32_ps( FetchY0 ) );
+
+    // NOTE(oyvind): +1 unless already on the last texel (the compare gives -1 where true)
+    __m128i FetchX1 = _mm_sub_epi32( FetchX0, _mm_cmplt_epi32( FetchX0, _mm_set1_epi32( Texture->Width - 1 ) ) );
+    __m128i FetchY1 = _mm_sub_epi32( FetchY0, _mm_cmplt_epi32( FetchY0, _mm_set1_epi32( Texture->Height - 1 ) ) );
+
+    // TODO(oyvind): No gather in SSE2, the 16 fetches are scalar
+    int32 X0[4], Y0[4], X1[4], Y1[4];
+    _mm_storeu_si128( (__m128i*)X0, FetchX0 );
+    _mm_storeu_si128( (__m128i*)Y0, FetchY0 );
+    _mm_storeu_si128( (__m128i*)X1, FetchX1 );
+    _mm_storeu_si128( (__m128i*)Y1, FetchY1 );
+
+    uint32 Texel00[4], Texel10[4], Texel01[4], Texel11[4];
+    for ( int Lane = 0; Lane < 4; ++Lane )
+    {
+        uint32* Row0 = (uint32*)((uint8*)Texture->Memory + Y0[Lane] * Texture->Pitch);
+        uint32* Row1 = (uint32*)((uint8*)Texture->Memory + Y1[Lane] * Texture->Pitch);
+        Texel00[Lane] = Row0[X0[Lane]];
+        Texel10[Lane] = Row0[X1[Lane]];
+        Texel01[Lane] = Row1[X0[Lane]];
+        Texel11[Lane] = Row1[X1[Lane]];
+    }
+
+    __m128 InvFracX = _mm_sub_ps( One, FracX );
+    __m128 InvFracY = _mm_sub_ps( One, FracY );
+    __m128 Weights[4] =
+    {
+        _mm_mul_ps( InvFracX, InvFracY ),
+        _mm_mul_ps( FracX, InvFracY ),
+        _mm_mul_ps( InvFracX, FracY ),
+        _mm_mul_ps( FracX, FracY ),
+    };
+    uint32* Texels[4] = { Texel00, Texel10, Texel01, Texel11 };
+
+    __m128 R = Zero;
+    __m128 G = Zero;
+    __m128 B = Zero;
+    __m128 A = Zero;
+    for ( int Corner = 0; Corner < 4; ++Corner )
+    {
+        __m128i Texel = _mm_loadu_si128( (__m128i*)Texels[Corner] );
+        __m128 WeightedAlpha = _mm_mul_ps( Weights[Corner], _mm_mul_ps( UnpackChannel( Texel, 24 ), Inv255 ) );
+        R = _mm_add_ps( R, _mm_mul_ps( WeightedAlpha, UnpackChannel( Texel, 16 ) ) );
+        G = _mm_add_ps( G, _mm_mul_ps( WeightedAlpha, UnpackChannel( Texel, 8 ) ) );
+        B = _mm_add_ps( B, _mm_mul_ps( WeightedAlpha, UnpackChannel( Texel, 0 ) ) );
+        A = _mm_add_ps( A, WeightedAlpha );
+    }
+
+    __m128 InvA = _mm_sub_ps( One, A );
+    R = _mm_add_ps( R, _mm_mul_ps( InvA, UnpackChannel( Dest, 16 ) ) );
+    G = _mm_add_ps( G, _mm_mul_ps( InvA, UnpackChannel( Dest, 8 ) ) );
+    B = _mm_add_ps( B, _mm_mul_ps( InvA, UnpackChannel( Dest, 0 ) ) );
+
+    __m128i Result = _mm_or_si128( _mm_or_si128(
+        _mm_slli_epi32( _mm_cvtps_epi32( R ), 16 ),
+        _mm_slli_epi32( _mm_cvtps_epi32( G ), 8 ) ),
+        _mm_cvtps_epi32( B ) );
+
+    return Result;
+}
+
+#undef UnpackChannel
+
+//===============================================================
+// @Purpose: Rasterize one triangle inside Rect, which is never
+// bigger than a tile. Walks 4x4 pixel blocks, rejects a block
+// when its corners are all outside one edge, and evaluates the
+// surviving blocks one 4-pixel row per SSE register.
+//===============================================================
+INTERNAL void RasterizeTriangle( gfs_offscreen_buffer* Buffer, render_rect Rect, render_triangle* Triangle, loaded_bitmap* Texture, uint32 Color )
+{
+    // NOTE(oyvind): Blocks start at Rect.Min and can hang 3 pixels past Rect.Max
+    int64 LastX = (Rect.MaxX - Rect.MinX - 1) + 3;
+    int64 LastY = (Rect.MaxY - Rect.MinY - 1) + 3;
+
+    int32 RowE[3];
+    int32 StepX[3];
+    int32 StepY[3];
+    for ( int EdgeIndex = 0; EdgeIndex < 3; ++EdgeIndex )
+    {
+        int64 StepX64 = Triangle->EdgeA[EdgeIndex] * RENDER_SUBPIXEL_ONE;
+        int64 StepY64 = Triangle->EdgeB[EdgeIndex] * RENDER_SUBPIXEL_ONE;
+        int64 E = Triangle->EdgeA[EdgeIndex] * ((int64)Rect.MinX * RENDER_SUBPIXEL_ONE + RENDER_SUBPIXEL_ONE / 2) +
+                  Triangle->EdgeB[EdgeIndex] * ((int64)Rect.MinY * RENDER_SUBPIXEL_ONE + RENDER_SUBPIXEL_ONE / 2) +
+                  Triangle->EdgeC[EdgeIndex];
+
+        int64 Min = E + ((StepX64 < 0) ? StepX64 * LastX : 0) + ((StepY64 < 0) ? StepY64 * LastY : 0);
+        int64 Max = E + ((StepX64 > 0) ? StepX64 * LastX : 0) + ((StepY64 > 0) ? StepY64 * LastY : 0);
+        if ( Max < 0 )
+        {
+            return;
+        }
+
+        if ( Min >= 0 )
+        {
+            // NOTE(oyvind): Inside everywhere here. Far from the edge E can be huge, so drop it.
+            RowE[EdgeIndex] = 0;
+            StepX[EdgeIndex] = 0;
+            StepY[EdgeIndex] = 0;
+        }
+        else
+        {
+            // NOTE(oyvind): The edge crosses the rect, so E stays within a tile's worth of
+            // steps of zero. With RENDER_GUARD_BAND that always fits in int32.
+            RowE[EdgeIndex] = (int32)E;
+            StepX[EdgeIndex] = (int32)StepX64;
+            StepY[EdgeIndex] = (int32)StepY64;
+        }
+    }
+
+    __m128i LaneIndex = _mm_set_epi32( 3, 2, 1, 0 );
+    __m128 LaneIndexF = _mm_set_ps( 3.0f, 2.0f, 1.0f, 0.0f );
+    __m128i MaxX4 = _mm_set1_epi32( Rect.MaxX );
+    __m128i LaneStepX[3];
+    for ( int EdgeIndex = 0; EdgeIndex < 3; ++EdgeIndex )
+    {
+        LaneStepX[EdgeIndex] = _mm_set_epi32( 3 * StepX[EdgeIndex], 2 * StepX[EdgeIndex], StepX[EdgeIndex], 0 );
+    }
+    __m128i Solid = _mm_set1_epi32( (int32)(Color & 0x00FFFFFF) );
+
+    for ( int32 BlockY = Rect.MinY; BlockY < Rect.MaxY; BlockY += 4 )
+    {
+        int32 BlockE[3] = { RowE[0], RowE[1], RowE[2] };
+        int32 RowCount = (Rect.MaxY - BlockY < 4) ? (Rect.MaxY - BlockY) : 4;
+
+        for ( int32 BlockX = Rect.MinX; BlockX < Rect.MaxX; BlockX += 4 )
+        {
+            bool32 Rejected = false;
+            for ( int EdgeIndex = 0; EdgeIndex < 3; ++EdgeIndex )
+            {
+                int32 BlockMax = BlockE[EdgeIndex] +
+                    ((StepX[EdgeIndex] > 0) ? 3 * StepX[EdgeIndex] : 0) +
+                    ((StepY[EdgeIndex] > 0) ? 3 * StepY[EdgeIndex] : 0);
+                Rejected |= (BlockMax < 0);
+            }
+
+            if ( !Rejected )
+            {
+                __m128i ColumnMask = _mm_cmplt_epi32( _mm_add_epi32( _mm_set1_epi32( BlockX ), LaneIndex ), MaxX4 );
+                bool32 PastRowEnd = (BlockX + 4 > Buffer->Width);
+
+                for ( int32 Row = 0; Row < RowCount; ++Row )
+                {
+                    __m128i E0 = _mm_add_epi32( _mm_set1_epi32( BlockE[0] + Row * StepY[0] ), LaneStepX[0] );
+                    __m128i E1 = _mm_add_epi32( _mm_set1_epi32( BlockE[1] + Row * StepY[1] ), LaneStepX[1] );
+                    __m128i E2 = _mm_add_epi32( _mm_set1_epi32( BlockE[2] + Row * StepY[2] ), LaneStepX[2] );
+
+                    // NOTE(oyvind): Sign bit of any edge set means outside
+                    __m128i Outside = _mm_srai_epi32( _mm_or_si128( _mm_or_si128( E0, E1 ), E2 ), 31 );
+                    __m128i Mask = _mm_andnot_si128( Outside, ColumnMask );
+                    if ( _mm_movemask_epi8( Mask ) == 0 )
+                    {
+                        continue;
+                    }
+
+                    int32 Y = BlockY + Row;
+                    uint32* Pixel = (uint32*)((uint8*)Buffer->Memory + Y * Buffer->Pitch) + BlockX;
+
+                    // NOTE(oyvind): Never touch memory past the end of the row, it may be past the end of the buffer
+                    uint32 Edge[4] = {};
+                    __m128i Dest;
+                    if ( PastRowEnd )
+                    {
+                        for ( int32 Lane = 0; BlockX + Lane < Buffer->Width; ++Lane ) Edge[Lane] = Pixel[Lane];
+                        Dest = _mm_loadu_si128( (__m128i*)Edge );
+                    }
+                    else
+                    {
+                        Dest = _mm_loadu_si128( (__m128i*)Pixel );
+                    }
+
+                    __m128i Shaded = Solid;
+                    if ( Texture )
+                    {
+                        __m128 TexelX = _mm_add_ps(
+                            _mm_set1_ps( Triangle->TexelX0 + Triangle->TexelXdX * (real32)BlockX + Triangle->TexelXdY * (real32)Y ),
+                            _mm_mul_ps( _mm_set1_ps( Triangle->TexelXdX ), LaneIndexF ) );
+                        __m128 TexelY = _mm_add_ps(
+                            _mm_set1_ps( Triangle->TexelY0 + Triangle->TexelYdX * (real32)BlockX + Triangle->TexelYdY * (real32)Y ),
+                            _mm_mul_ps( _mm_set1_ps( Triangle->TexelYdX ), LaneIndexF ) );
+                        Shaded = ShadeBilinear4( Texture, TexelX, TexelY, Dest );
+                    }
+
+                    __m128i Out = _mm_or_si128( _mm_and_si128( Mask, Shaded ), _mm_andnot_si128( Mask, Dest ) );
+                    if ( PastRowEnd )
+                    {
+                        _mm_storeu_si128( (__m128i*)Edge, Out );
+                        for ( int32 Lane = 0; BlockX + Lane < Buffer->Width; ++Lane ) Pixel[Lane] = Edge[Lane];
+                    }
+                    else
+                    {
+                        _mm_storeu_si128( (__m128i*)Pixel, Out );
+                    }
+                }
+            }
+
+            for ( int EdgeIndex = 0; EdgeIndex < 3; ++EdgeIndex )
+            {
+                BlockE[EdgeIndex] += 4 * StepX[EdgeIndex];
+            }
+        }
+
+        for ( int EdgeIndex = 0; EdgeIndex < 3; ++EdgeIndex )
+        {
+            RowE[EdgeIndex] += 4 * StepY[EdgeIndex];
+        }
+    }
+}
+
+//===============================================================
+// @Purpose: Set up every triangle in the batch once, bin them by
+// the RENDER_TILE_SIZE tiles their bounds touch, then walk the
+// tiles. Each tile draws its triangles in submission order, so
+// blending comes out the same as drawing them one by one.
+//===============================================================
+INTERNAL void DrawTriangles( gfs_offscreen_buffer* Buffer, render_rect Clip, memory_arena* Arena, render_entry_triangles* Entry, uint32* DrawnTriangleCount )
+{
+    BEGIN_TIMED_BLOCK( DrawTriangles );
+
+    render_vertex* Vertices = (render_vertex*)(Entry + 1);
+    render_triangle* Triangles = PushArray( Arena, Entry->TriangleCount, render_triangle, MemoryTag_Render );
+    uint32 TriangleCount = 0;
+    for ( uint32 Index = 0; Index < Entry->TriangleCount; ++Index )
+    {
+        if ( SetupTriangle( Triangles + TriangleCount, Vertices + 3 * Index, Clip, Entry->Texture ) )
+        {
+            ++TriangleCount;
+        }
+    }
+
+    int32 TileMinX = Clip.MinX / RENDER_TILE_SIZE;
+    int32 TileMinY = Clip.MinY / RENDER_TILE_SIZE;
+    int32 TileCountX = (Clip.MaxX - 1) / RENDER_TILE_SIZE - TileMinX + 1;
+    int32 TileCountY = (Clip.MaxY - 1) / RENDER_TILE_SIZE - TileMinY + 1;
+    int32 TileCount = TileCountX * TileCountY;
+
+    // NOTE(oyvind): Counting sort into one flat index list, TileStart[Tile]..TileStart[Tile + 1]
+    uint32* TileStart = PushArray( Arena, TileCount + 1, uint32, MemoryTag_Render );
+    uint32* TileFill = PushArray( Arena, TileCount, uint32, MemoryTag_Render );
+    for ( int32 Tile = 0; Tile <= TileCount; ++Tile )
+    {
+        TileStart[Tile] = 0;
+    }
+
+    for ( uint32 Index = 0; Index < TriangleCount; ++Index )
+    {
+        render_rect Bounds = Triangles[Index].Bounds;
+        for ( int32 TileY = Bounds.MinY / RENDER_TILE_SIZE; TileY <= (Bounds.MaxY - 1) / RENDER_TILE_SIZE; ++TileY )
+        {
+            for ( int32 TileX = Bounds.MinX / RENDER_TILE_SIZE; TileX <= (Bounds.MaxX - 1) / RENDER_TILE_SIZE; ++TileX )
+            {
+                ++TileStart[(TileY - TileMinY) * TileCountX + (TileX - TileMinX) + 1];
+            }
+        }
+    }
+
+    for ( int32 Tile = 0; Tile < TileCount; ++Tile )
+    {
+        TileStart[Tile + 1] += TileStart[Tile];
+        TileFill[Tile] = TileStart[Tile];
+    }
+
+    uint32* BinnedTriangles = PushArray( Arena, TileStart[TileCount], uint32, MemoryTag_Render );
+    for ( uint32 Index = 0; Index < TriangleCount; ++Index )
+    {
+        render_rect Bounds = Triangles[Index].Bounds;
+        for ( int32 TileY = Bounds.MinY / RENDER_TILE_SIZE; TileY <= (Bounds.MaxY - 1) / RENDER_TILE_SIZE; ++TileY )
+        {
+            for ( int32 TileX = Bounds.MinX / RENDER_TILE_SIZE; TileX <= (Bounds.MaxX - 1) / RENDER_TILE_SIZE; ++TileX )
+            {
+                int32 Tile = (TileY - TileMinY) * TileCountX + (TileX - TileMinX);
+                BinnedTriangles[TileFill[Tile]++] = Index;
+            }
+        }
+    }
+
+    for ( int32 TileY = 0; TileY < TileCountY; ++TileY )
+    {
+        for ( int32 TileX = 0; TileX < TileCountX; ++TileX )
+        {
+            int32 Tile = TileY * TileCountX + TileX;
+            render_rect TileRect;
+            TileRect.MinX = (TileMinX + TileX) * RENDER_TILE_SIZE;
+            TileRect.MinY = (TileMinY + TileY) * RENDER_TILE_SIZE;
+            TileRect.MaxX = TileRect.MinX + RENDER_TILE_SIZE;
+            TileRect.MaxY = TileRect.MinY + RENDER_TILE_SIZE;
+
+            for ( uint32 BinIndex = TileStart[Tile]; BinIndex < TileStart[Tile + 1]; ++BinIndex )
+            {
+                render_triangle* Triangle = Triangles + BinnedTriangles[BinIndex];
+                render_rect Rect = Triangle->Bounds;
+                if ( Rect.MinX < TileRect.MinX ) Rect.MinX = TileRect.MinX;
+                if ( Rect.MinY < TileRect.MinY ) Rect.MinY = TileRect.MinY;
+                if ( Rect.MaxX > TileRect.MaxX ) Rect.MaxX = TileRect.MaxX;
+                if ( Rect.MaxY > TileRect.MaxY ) Rect.MaxY = TileRect.MaxY;
+
+                RasterizeTriangle( Buffer, Rect, Triangle, Entry->Texture, Entry->Color );
+            }
+        }
+    }
+
+    *DrawnTriangleCount += TriangleCount;
+
+    END_TIMED_BLOCK( DrawTriangles );
+}
+
+//===============================================================
+// @Purpose: Sort, cull, merge and execute everything pushed this
+// frame, then empty the group for reuse.
+//===============================================================
+INTERNAL void RenderGroupToOutput( render_group* Group, gfs_offscreen_buffer* Buffer )
+{
+    BEGIN_TIMED_BLOCK( RenderGroupToOutput );
+
+    Group->CulledCount = 0;
+    Group->MergedCount = 0;
+    Group->DrawnCount = 0;
+    Group->TriangleCount = 0;
+
+    SortRenderEntries( Group );
+    CullRenderEntries( Group, Buffer );
+    MergeRenderEntries( Group );
+
+    for ( uint32 Index = 0; Index < Group->EntryCount; ++Index )
+    {
+        render_sort_entry* SortEntry = Group->SortEntries + Index;
+        if ( SortEntry->PushBufferOffset == RENDER_ENTRY_CULLED )
+        {
+            continue;
+        }
+
+        render_entry_header* Header = (render_entry_header*)(Group->PushBufferBase + SortEntry->PushBufferOffset);
+        render_rect Bounds = GetRenderEntryBounds( Header, Buffer );
+        if ( RenderRectIsEmpty( Bounds ) )
+        {
+            continue;
+        }
+
+        switch ( Header->Type )
+        {
+            case RenderEntry_Clear:
+            {
+                render_entry_clear* Entry = (render_entry_clear*)(Header + 1);
+                DrawRectangle( Buffer, Bounds, Entry->Color );
+            } break;
+
+            case RenderEntry_Rectangle:
+            {
+                render_entry_rectangle* Entry = (render_entry_rectangle*)(Header + 1);
+                DrawRectangle( Buffer, Bounds, Entry->Color );
+            } break;
+
+            case RenderEntry_Bitmap:
+            {
+                render_entry_bitmap* Entry = (render_entry_bitmap*)(Header + 1);
+                DrawBitmap( Buffer, Bounds, Entry->Bitmap, RoundReal32ToInt32( Entry->X ), RoundReal32ToInt32( Entry->Y ) );
+            } break;
+
+            case RenderEntry_Triangles:
+            {
+                render_entry_triangles* Entry = (render_entry_triangles*)(Header + 1);
+                DrawTriangles( Buffer, Bounds, Group->ScratchArena, Entry, &Group->TriangleCount );
+            } break;
+
+            default:
+            {
+                Assert( !"Unknown render entry type" );
+            } break;
+        }
+
+        ++Group->DrawnCount;
+    }
+
+    if ( GlobalDebugState )
+    {
+        debug_render_stats* Stats = &GlobalDebugState->RenderStats;
+        Stats->CulledCount += Group->CulledCount;
+        Stats->MergedCount += Group->MergedCount;
+        Stats->DrawnCount += Group->DrawnCount;
+        Stats->TriangleCount += Group->TriangleCount;
+    }
+
+    Group->PushBufferSize = 0;
+    Group->EntryCount = 0;
+
+    END_TIMED_BLOCK( RenderGroupToOutput );
+}
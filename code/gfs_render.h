@@ -0,0 +1,131 @@
+#pragma once
+/*===============================================================
+ @Purpose: Push-buffer renderer
+ @Creator: Oyvind Andersson
+ @Notice : The game never touches pixels while it simulates. It
+           pushes compact commands into a render_group living in
+           the transient arena, and RenderGroupToOutput does all
+           the rasterization in one go:
+             1. sort by layer, then material (so same-state work
+                is adjacent), then push order, which keeps it stable
+             2. cull against the viewport, and back to front
+                against opaque rectangles drawn later
+             3. merge neighbouring same-colored rectangles
+             4. execute what is left
+           Triangle batches are set up once, binned into screen
+           tiles and rasterized tile by tile with edge functions,
+           so a big batch touches each part of the backbuffer in
+           one go instead of once per triangle.
+           Layer order is draw order. Within a layer, order is only
+           guaranteed between entries of the same material.
+=================================================================*/
+
+struct loaded_bitmap
+{
+    int32 Width;
+    int32 Height;
+    int32 Pitch;
+    void* Memory; // NOTE(oyvind): 32-bit pixels, mem order BB GG RR AA, not premultiplied
+};
+
+enum render_entry_type
+{
+    RenderEntry_Clear,
+    RenderEntry_Rectangle,
+    RenderEntry_Bitmap,
+    RenderEntry_Triangles,
+};
+
+// NOTE(oyvind): 8 bytes, so the entry body that follows is 8-byte aligned
+struct render_entry_header
+{
+    uint16 Type;
+    uint16 Layer;
+    uint32 PushIndex;
+};
+
+// NOTE(oyvind): Clear always sorts first, whatever layer or order it was pushed in
+struct render_entry_clear
+{
+    uint32 Color;
+};
+
+// NOTE(oyvind): Rectangles are opaque, Max is exclusive
+struct render_entry_rectangle
+{
+    real32 MinX;
+    real32 MinY;
+    real32 MaxX;
+    real32 MaxY;
+    uint32 Color;
+};
+
+struct render_entry_bitmap
+{
+    loaded_bitmap* Bitmap;
+    real32 X;
+    real32 Y;
+};
+
+// NOTE(oyvind): X/Y in screen pixels (pixel centers at +0.5), U/V normalized and clamped to the texture edge
+struct render_vertex
+{
+    real32 X;
+    real32 Y;
+    real32 U;
+    real32 V;
+};
+
+// NOTE(oyvind): TriangleCount*3 render_vertex follow the entry in the push buffer.
+// Textured triangles are bilinear filtered and alpha blended, untextured ones are
+// filled opaque with Color. Either winding is fine.
+struct render_entry_triangles
+{
+    loaded_bitmap* Texture;
+    uint32 Color;
+    uint32 TriangleCount;
+};
+
+struct render_sort_entry
+{
+    uint64 SortKey; // Layer:16 | Material:16 | PushIndex:32
+    uint32 PushBufferOffset;
+};
+
+#define RENDER_ENTRY_CULLED 0xFFFFFFFF
+#define RENDER_MAX_OCCLUDER_COUNT 8
+
+#define RENDER_SUBPIXEL_BITS 4
+#define RENDER_SUBPIXEL_ONE (1 << RENDER_SUBPIXEL_BITS)
+#define RENDER_TILE_SIZE 64
+// NOTE(oyvind): Keeps edge functions inside int32 within a tile, see RasterizeTriangle
+#define RENDER_GUARD_BAND 8192.0f
+
+struct render_group
+{
+    uint32 MaxPushBufferSize;
+    uint32 PushBufferSize;
+    uint8* PushBufferBase;
+
+    uint32 MaxEntryCount;
+    uint32 EntryCount;
+    render_sort_entry* SortEntries;
+    render_sort_entry* SortTemp;
+
+    // NOTE(oyvind): The transient arena the group lives in, scratch for triangle setup and binning
+    memory_arena* ScratchArena;
+
+    // NOTE(oyvind): Filled in by RenderGroupToOutput and added to the debug HUD's render stats
+    uint32 CulledCount;
+    uint32 MergedCount;
+    uint32 DrawnCount;
+    uint32 TriangleCount;
+};
+
+INTERNAL render_group* AllocateRenderGroup( memory_arena* Arena, uint32 MaxPushBufferSize, uint32 MaxEntryCount );
+INTERNAL void PushClear( render_group* Group, uint32 Color );
+INTERNAL void PushRectangle( render_group* Group, uint16 Layer, real32 MinX, real32 MinY, real32 MaxX, real32 MaxY, uint32 Color );
+INTERNAL void PushBitmap( render_group* Group, uint16 Layer, loaded_bitmap* Bitmap, real32 X, real32 Y );
+INTERNAL void PushTriangles( render_group* Group, uint16 Layer, loaded_bitmap* Texture, uint32 Color, render_vertex* Vertices, uint32 TriangleCount );
+INTERNAL void PushSprite( render_group* Group, uint16 Layer, loaded_bitmap* Bitmap, real32 CenterX, real32 CenterY, real32 Angle, real32 Scale );
+INTERNAL void RenderGroupToOutput( render_group* Group, gfs_offscreen_buffer* Buffer );
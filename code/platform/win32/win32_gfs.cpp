@@ -56,12 +56,21 @@ struct win32_sound_output
     int SamplesPerSecond;
     int ToneHz;
     int ToneVolume;
-    uint32 RunningSampleIndex;
+    uint64 RunningSampleIndex; // Absolute index of the next sample we write
     int WavePeriod;
     int BytesPerSample;
     int32 SecondaryBufferSize;
     real32 tSine;
-    int LatencySampleCount;
+
+    // NOTE(oyvind): Absolute index of the sample under the play cursor, kept by
+    // accumulating how far the cursor moved since last frame
+    uint64 PlaySampleIndex;
+    DWORD LastPlayCursor;
+
+    int SamplesPerFrame;
+    int SafetySampleCount; // How far past the write cursor we write, to ride out frame jitter
+    int ExpectedFrameSampleCount; // Measured frame time in samples, smoothed
+    int SilenceSampleCount; // Zeroes written past the target, so a late frame plays silence instead of stale audio
 };
 
 //===============================================================
@@ -100,6 +109,8 @@ typedef DIRECT_SOUND_CREATE( direct_sound_create );
 GLOBALVAR bool32 GlobalRunning;
 GLOBALVAR win32_offscreen_buffer GlobalBackBuffer;
 GLOBALVAR LPDIRECTSOUNDBUFFER GlobalSecondaryBuffer;
+GLOBALVAR gfs_memory_stats GlobalMemoryStats;
+GLOBALVAR bool32 GlobalMemoryReportRequested;
 
 //===============================================================
 // Helper functions
@@ -116,6 +127,190 @@ INTERNAL win32_window_dimension Win32GetWindowDimension(HWND Window)
     return Result;
 }
 
+//===============================================================
+// Tracked memory
+// NOTE(oyvind): All OS allocations must go through these, so
+// GlobalMemoryStats sees every byte we own.
+//===============================================================
+
+INTERNAL void* Win32AllocateMemory( memory_index Size, memory_tag Tag )
+{
+    void* Result = VirtualAlloc( 0, Size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE );
+    if ( Result )
+    {
+        RecordBlockAllocated( &GlobalMemoryStats, Tag, Size );
+    }
+    else
+    {
+        // TODO(oyvind): Logging
+    }
+
+    return Result;
+}
+
+INTERNAL void Win32FreeMemory( void* Memory, memory_index Size, memory_tag Tag )
+{
+    if ( Memory )
+    {
+        VirtualFree( Memory, 0, MEM_RELEASE );
+        RecordBlockFreed( &GlobalMemoryStats, Tag, Size );
+    }
+}
+
+INTERNAL bool32 Win32WriteEntireFile( const char* FileName, void* Memory, uint32 MemorySize )
+{
+    bool32 Result = false;
+
+    HANDLE FileHandle = CreateFileA( FileName, GENERIC_WRITE, 0, 0, CREATE_ALWAYS, 0, 0 );
+    if ( FileHandle != INVALID_HANDLE_VALUE )
+    {
+        DWORD BytesWritten;
+        if ( WriteFile( FileHandle, Memory, MemorySize, &BytesWritten, 0 ) )
+        {
+            Result = (BytesWritten == MemorySize);
+        }
+        else
+        {
+            // TODO(oyvind): Logging
+        }
+
+        CloseHandle( FileHandle );
+    }
+    else
+    {
+        // TODO(oyvind): Logging
+    }
+
+    return Result;
+}
+
+//===============================================================
+// Memory mapped files
+// NOTE(oyvind): Only one view per file is live at a time. Views
+// are accounted under MemoryTag_MappedFile.
+//===============================================================
+
+PLATFORM_OPEN_MAPPED_FILE( Win32OpenMappedFile )
+{
+    *File = {};
+
+    HANDLE FileHandle = CreateFileA( FileName, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0 );
+    if ( FileHandle == INVALID_HANDLE_VALUE )
+    {
+        // TODO(oyvind): Logging
+        return false;
+    }
+
+    LARGE_INTEGER FileSize;
+    if ( !GetFileSizeEx( FileHandle, &FileSize ) || (FileSize.QuadPart == 0) )
+    {
+        CloseHandle( FileHandle );
+        return false;
+    }
+
+    HANDLE MappingHandle = CreateFileMappingA( FileHandle, 0, PAGE_READONLY, 0, 0, 0 );
+    if ( !MappingHandle )
+    {
+        // TODO(oyvind): Logging
+        CloseHandle( FileHandle );
+        return false;
+    }
+
+    File->Size = FileSize.QuadPart;
+    File->FileHandle = FileHandle;
+    File->MappingHandle = MappingHandle;
+    return true;
+}
+
+INTERNAL void Win32UnmapFileView( platform_mapped_file* File )
+{
+    if ( File->View )
+    {
+        UnmapViewOfFile( File->View );
+        RecordBlockFreed( &GlobalMemoryStats, MemoryTag_MappedFile, File->ViewSize );
+        File->View = 0;
+        File->ViewSize = 0;
+    }
+}
+
+PLATFORM_MAP_FILE_WINDOW( Win32MapFileWindow )
+{
+    Assert( Offset + Size <= File->Size );
+    Win32UnmapFileView( File );
+
+    // NOTE(oyvind): View offsets must be a multiple of the allocation granularity (usually 64k)
+    LOCALPERSIST DWORD AllocationGranularity;
+    if ( !AllocationGranularity )
+    {
+        SYSTEM_INFO SystemInfo;
+        GetSystemInfo( &SystemInfo );
+        AllocationGranularity = SystemInfo.dwAllocationGranularity;
+    }
+
+    uint64 ViewOffset = Offset - (Offset % AllocationGranularity);
+    memory_index ViewSize = (memory_index)(Offset - ViewOffset) + Size;
+
+    void* View = MapViewOfFile( File->MappingHandle, FILE_MAP_READ, (DWORD)(ViewOffset >> 32), (DWORD)(ViewOffset & 0xFFFFFFFF), ViewSize );
+    if ( !View )
+    {
+        // TODO(oyvind): Logging
+        return 0;
+    }
+
+    File->View = View;
+    File->ViewSize = ViewSize;
+    RecordBlockAllocated( &GlobalMemoryStats, MemoryTag_MappedFile, ViewSize );
+
+    return (uint8*)View + (Offset - ViewOffset);
+}
+
+PLATFORM_CLOSE_MAPPED_FILE( Win32CloseMappedFile )
+{
+    Win32UnmapFileView( File );
+
+    if ( File->MappingHandle )
+    {
+        CloseHandle( File->MappingHandle );
+    }
+    if ( File->FileHandle )
+    {
+        CloseHandle( File->FileHandle );
+    }
+
+    *File = {};
+}
+
+// NOTE(oyvind): Text to the debugger, text and JSON to disk. Both F1 and exit end up here.
+INTERNAL void Win32OutputMemoryReport()
+{
+    char ReportBuffer[MEMORY_REPORT_MAX_SIZE];
+
+    memory_index ReportSize = FormatMemoryReport( &GlobalMemoryStats, ReportBuffer, sizeof( ReportBuffer ) );
+    OutputDebugStringA( ReportBuffer );
+    if ( ReportSize < sizeof( ReportBuffer ) )
+    {
+        Win32WriteEntireFile( "memory_report.txt", ReportBuffer, (uint32)ReportSize );
+    }
+    else
+    {
+        // TODO(oyvind): Logging
+        OutputDebugStringA( "Memory report truncated, raise MEMORY_REPORT_MAX_SIZE\n" );
+        Assert( !"Memory report truncated" );
+    }
+
+    ReportSize = FormatMemoryReportJSON( &GlobalMemoryStats, ReportBuffer, sizeof( ReportBuffer ) );
+    if ( ReportSize < sizeof( ReportBuffer ) )
+    {
+        Win32WriteEntireFile( "memory_report.json", ReportBuffer, (uint32)ReportSize );
+    }
+    else
+    {
+        // NOTE(oyvind): Cut-off JSON is useless to tools, don't write it
+        OutputDebugStringA( "Memory report JSON truncated, raise MEMORY_REPORT_MAX_SIZE\n" );
+        Assert( !"Memory report JSON truncated" );
+    }
+}
+
 INTERNAL void ClearToBlack(win32_offscreen_buffer Buffer)
 {
     uint8 *Row = (uint8 *)Buffer.Memory;
@@ -135,14 +330,15 @@ INTERNAL void Win32ResizeDIBSection(win32_offscreen_buffer* Buffer, int Width, i
 {
     // TODO(oyvind): Maybe don't free first, free after, then free first if that fails.
 
+    int BytesPerPixel = 4;
+
     if(Buffer->Memory)
     {
-        VirtualFree(Buffer->Memory, 0, MEM_RELEASE);
+        Win32FreeMemory(Buffer->Memory, Buffer->Width * Buffer->Height * BytesPerPixel, MemoryTag_BackBuffer);
     }
 
     Buffer->Width = Width;
     Buffer->Height = Height;
-    int BytesPerPixel = 4;
 
     // NOTE(oyvind): When biHeight is negative, that clues Windows to treat this bitmap as top-down.
     // The first three bytes of the image are the color for the top left pixel in the bitmap, not bottom-left!
@@ -154,7 +350,7 @@ INTERNAL void Win32ResizeDIBSection(win32_offscreen_buffer* Buffer, int Width, i
     Buffer->Info.bmiHeader.biCompression = BI_RGB;
 
     int BitmapImageMemorySize = Buffer->Width * Buffer->Height * BytesPerPixel;
-    Buffer->Memory = VirtualAlloc(0, BitmapImageMemorySize, MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
+    Buffer->Memory = Win32AllocateMemory(BitmapImageMemorySize, MemoryTag_BackBuffer);
     Buffer->Pitch = Buffer->Width * BytesPerPixel;
 
     ClearToBlack( GlobalBackBuffer );
@@ -298,37 +494,45 @@ INTERNAL void Win32ClearBuffer( win32_sound_output* SoundOutput )
     }
 }
 
-INTERNAL void Win32FillSoundBuffer( win32_sound_output* SoundOutput, DWORD BytesToLock, DWORD BytesToWrite, gfs_sound_buffer* SourceBuffer )
+// NOTE(oyvind): Writes the game's samples, then SilenceBytes of zeroes after them. The zeroes
+// are overwritten by the next frame as usual, but if that frame is late the card plays
+// silence instead of whatever was in the ring buffer a second ago.
+INTERNAL void Win32FillSoundBuffer( win32_sound_output* SoundOutput, DWORD BytesToLock, DWORD BytesToWrite, DWORD SilenceBytes, gfs_sound_buffer* SourceBuffer )
 {
     VOID* Region1;
     DWORD Region1Size;
     VOID* Region2;
     DWORD Region2Size;
 
-    if ( SUCCEEDED( GlobalSecondaryBuffer->Lock( BytesToLock, BytesToWrite,
+    if ( SUCCEEDED( GlobalSecondaryBuffer->Lock( BytesToLock, BytesToWrite + SilenceBytes,
         &Region1, &Region1Size,
         &Region2, &Region2Size,
         0 ) ) )
     {
-        // TODO(oyvind): Collapse these two loops
-        DWORD Region1SampleCount = Region1Size / SoundOutput->BytesPerSample;
-        int16* DestSample = (int16*)Region1;
+        DWORD SourceSampleCount = BytesToWrite / SoundOutput->BytesPerSample;
         int16* SourceSample = (int16*)SourceBuffer->Samples;
 
-        for ( DWORD SampleIndex = 0; SampleIndex < Region1SampleCount; ++SampleIndex )
-        {
-            *DestSample++ = *SourceSample++; // Ch1
-            *DestSample++ = *SourceSample++; // Ch2
-            ++SoundOutput->RunningSampleIndex;
-        }
-
-        DWORD Region2SampleCount = Region2Size / SoundOutput->BytesPerSample;
-        DestSample = (int16*)Region2;
-        for ( DWORD SampleIndex = 0; SampleIndex < Region2SampleCount; ++SampleIndex )
+        VOID* Regions[2] = { Region1, Region2 };
+        DWORD RegionSizes[2] = { Region1Size, Region2Size };
+        for ( int RegionIndex = 0; RegionIndex < 2; ++RegionIndex )
         {
-            *DestSample++ = *SourceSample++; // Ch1
-            *DestSample++ = *SourceSample++; // Ch2
-            ++SoundOutput->RunningSampleIndex;
+            DWORD RegionSampleCount = RegionSizes[RegionIndex] / SoundOutput->BytesPerSample;
+            int16* DestSample = (int16*)Regions[RegionIndex];
+            for ( DWORD SampleIndex = 0; SampleIndex < RegionSampleCount; ++SampleIndex )
+            {
+                if ( SourceSampleCount > 0 )
+                {
+                    *DestSample++ = *SourceSample++; // Ch1
+                    *DestSample++ = *SourceSample++; // Ch2
+                    ++SoundOutput->RunningSampleIndex;
+                    --SourceSampleCount;
+                }
+                else
+                {
+                    *DestSample++ = 0;
+                    *DestSample++ = 0;
+                }
+            }
         }
 
         GlobalSecondaryBuffer->Unlock( Region1, Region1Size, Region2, Region2Size );
@@ -424,6 +628,20 @@ INTERNAL LRESULT CALLBACK Win32WindowCallback(HWND Window, UINT Message, WPARAM
                 {
                     GlobalRunning = false;
                 }
+                else if ( VKCode == VK_F1 )
+                {
+                    if ( IsDown )
+                    {
+                        GlobalMemoryReportRequested = true;
+                    }
+                }
+                else if ( VKCode == VK_F2 )
+                {
+                    if ( IsDown && GlobalDebugState )
+                    {
+                        GlobalDebugState->ShowHUD = !GlobalDebugState->ShowHUD;
+                    }
+                }
             }
 
             bool32 AltKeyWasDown = (LParam & (1 << 29)) != 0;
@@ -497,6 +715,9 @@ int WinMain( HINSTANCE Instance, HINSTANCE PrevWindow, LPSTR CmdLine, int ShowCm
             int XOffset = 0;
             int YOffset = 0;
 
+            // TODO(oyvind): Query the monitor refresh rate and actually lock to it
+            int GameUpdateHz = 60;
+
             win32_sound_output SoundOutput = {};
             SoundOutput.SamplesPerSecond = 48000;
             SoundOutput.ToneHz = 144;
@@ -505,7 +726,10 @@ int WinMain( HINSTANCE Instance, HINSTANCE PrevWindow, LPSTR CmdLine, int ShowCm
             SoundOutput.WavePeriod = SoundOutput.SamplesPerSecond / SoundOutput.ToneHz;
             SoundOutput.BytesPerSample = sizeof( int16 ) * 2;
             SoundOutput.SecondaryBufferSize = SoundOutput.SamplesPerSecond * SoundOutput.BytesPerSample;
-            SoundOutput.LatencySampleCount = SoundOutput.SamplesPerSecond / 15;
+            SoundOutput.SamplesPerFrame = SoundOutput.SamplesPerSecond / GameUpdateHz;
+            SoundOutput.SafetySampleCount = SoundOutput.SamplesPerFrame / 3;
+            SoundOutput.ExpectedFrameSampleCount = SoundOutput.SamplesPerFrame;
+            SoundOutput.SilenceSampleCount = SoundOutput.SamplesPerSecond / 4;
 
             Win32InitSound(Window, SoundOutput.SamplesPerSecond, SoundOutput.SecondaryBufferSize );
             Win32ClearBuffer( &SoundOutput );
@@ -513,13 +737,46 @@ int WinMain( HINSTANCE Instance, HINSTANCE PrevWindow, LPSTR CmdLine, int ShowCm
 
             GlobalRunning = true;
 
-            int16* Samples = (int16*)VirtualAlloc( 0, SoundOutput.SecondaryBufferSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE );
+            int16* Samples = (int16*)Win32AllocateMemory( SoundOutput.SecondaryBufferSize, MemoryTag_Sound );
+
+            // NOTE(oyvind): One block for all game memory, so it is contiguous and
+            // can be snapshotted later. Accounted as two tags.
+            gfs_memory GameMemory = {};
+            GameMemory.PermanentStorageSize = Megabytes( 64 );
+            GameMemory.TransientStorageSize = Megabytes( 128 );
+            GameMemory.Stats = &GlobalMemoryStats;
+            GameMemory.PlatformAPI.OpenMappedFile = Win32OpenMappedFile;
+            GameMemory.PlatformAPI.MapFileWindow = Win32MapFileWindow;
+            GameMemory.PlatformAPI.CloseMappedFile = Win32CloseMappedFile;
+
+            gfs_debug_state DebugState = {};
+            GameMemory.Debug = &DebugState;
+            GlobalDebugState = &DebugState;
+
+            uint64 TotalGameMemorySize = GameMemory.PermanentStorageSize + GameMemory.TransientStorageSize;
+            GameMemory.PermanentStorage = Win32AllocateMemory( (memory_index)TotalGameMemorySize, MemoryTag_GamePermanent );
+            if ( GameMemory.PermanentStorage )
+            {
+                GameMemory.TransientStorage = (uint8*)GameMemory.PermanentStorage + GameMemory.PermanentStorageSize;
+                RecordBlockSplit( &GlobalMemoryStats, MemoryTag_GamePermanent, MemoryTag_GameTransient, (memory_index)GameMemory.TransientStorageSize );
+            }
+
+            if ( !Samples || !GameMemory.PermanentStorage )
+            {
+                // TODO(oyvind): Logging
+                GlobalRunning = false;
+            }
+
+            // NOTE(oyvind): Nothing measured before the first frame, assume the target rate
+            real32 LastFrameSeconds = 1.0f / (real32)GameUpdateHz;
 
             LARGE_INTEGER LastCounter;
             QueryPerformanceCounter( &LastCounter );
             uint64 LastCycleCount = __rdtsc();
             while(GlobalRunning)
             {
+                BeginMemoryFrame( &GlobalMemoryStats );
+
                 //-------------------------------------------------------------------------------------------------
                 // Handle windows messages
                 //-------------------------------------------------------------------------------------------------
@@ -588,36 +845,80 @@ int WinMain( HINSTANCE Instance, HINSTANCE PrevWindow, LPSTR CmdLine, int ShowCm
                 // NOTE(oyvind): Render screen and audio
                 //-------------------------------------------------------------------------------------------------
                 
-                DWORD BytesToLock;
-                DWORD TargetCursor;
-                DWORD BytesToWrite;
+                DWORD BytesToLock = 0;
+                DWORD BytesToWrite = 0;
+                DWORD SilenceBytes = 0;
                 DWORD PlayCursor;
                 DWORD WriteCursor;
+                uint64 FlipSampleIndex = SoundOutput.RunningSampleIndex;
                 bool32 SoundIsValid = false;
 
-                // NOTE(oyvind): Figure out how much we should write to the ringbuffer
+                // NOTE(oyvind): Figure out how much we should write to the ringbuffer.
+                // Everything is done on absolute sample indices: we only ever write the samples
+                // from RunningSampleIndex up to where the next frame will pick up, and never
+                // write a sample twice.
                 if ( SUCCEEDED( GlobalSecondaryBuffer->GetCurrentPosition( &PlayCursor, &WriteCursor ) ) )
                 {
-                    BytesToLock = (SoundOutput.RunningSampleIndex * SoundOutput.BytesPerSample) % SoundOutput.SecondaryBufferSize;
-                    TargetCursor = (PlayCursor + (SoundOutput.LatencySampleCount * SoundOutput.BytesPerSample)) % SoundOutput.SecondaryBufferSize;
+                    DWORD BufferSize = SoundOutput.SecondaryBufferSize;
+                    DWORD PlayCursorDelta = (PlayCursor + BufferSize - SoundOutput.LastPlayCursor) % BufferSize;
+                    SoundOutput.PlaySampleIndex += PlayCursorDelta / SoundOutput.BytesPerSample;
+                    SoundOutput.LastPlayCursor = PlayCursor;
+
+                    DWORD WriteCursorLead = (WriteCursor + BufferSize - PlayCursor) % BufferSize;
+                    uint64 WriteSampleIndex = SoundOutput.PlaySampleIndex + WriteCursorLead / SoundOutput.BytesPerSample;
+                    if ( SoundOutput.RunningSampleIndex < WriteSampleIndex )
+                    {
+                        // NOTE(oyvind): We fell behind the card (hitch, breakpoint), skip ahead. What it
+                        // played in the gap is the silence padding from last frame, not stale audio.
+                        // The game derives everything from RunningSampleIndex, so it skips along.
+                        // TODO(oyvind): Logging
+                        SoundOutput.RunningSampleIndex = WriteSampleIndex;
+                    }
 
-                    if ( BytesToLock > TargetCursor )
+                    // NOTE(oyvind): No vsync yet (see GameUpdateHz), so the flip is when this
+                    // iteration ends, about one measured frame time from now.
+                    FlipSampleIndex = SoundOutput.PlaySampleIndex + SoundOutput.ExpectedFrameSampleCount;
+
+                    // NOTE(oyvind): Next frame starts writing where we stop, and by then the write
+                    // cursor has moved about a frame. Stopping short of that means skipping every frame.
+                    uint64 TargetSampleIndex;
+                    bool32 AudioCardIsLowLatency = (WriteSampleIndex + SoundOutput.SafetySampleCount) < FlipSampleIndex;
+                    if ( AudioCardIsLowLatency )
                     {
-                        BytesToWrite = SoundOutput.SecondaryBufferSize - BytesToLock;
-                        BytesToWrite += TargetCursor;
+                        // NOTE(oyvind): Events can land on the flip, cover up to the flip after it
+                        TargetSampleIndex = FlipSampleIndex + SoundOutput.ExpectedFrameSampleCount;
                     }
                     else
                     {
-                        BytesToWrite = TargetCursor - BytesToLock;
+                        // NOTE(oyvind): The card is already committed past the flip, so sound can't
+                        // line up with it. Events start on the first sample we still own.
+                        TargetSampleIndex = WriteSampleIndex + SoundOutput.ExpectedFrameSampleCount + SoundOutput.SafetySampleCount;
                     }
 
-                    SoundIsValid = true;
+                    if ( TargetSampleIndex > SoundOutput.RunningSampleIndex )
+                    {
+                        BytesToLock = (DWORD)((SoundOutput.RunningSampleIndex * SoundOutput.BytesPerSample) % BufferSize);
+                        BytesToWrite = (DWORD)(TargetSampleIndex - SoundOutput.RunningSampleIndex) * SoundOutput.BytesPerSample;
+
+                        // NOTE(oyvind): The padding must stop short of the play cursor
+                        uint64 BufferSampleCount = BufferSize / SoundOutput.BytesPerSample;
+                        uint64 SilenceSampleCount = SoundOutput.SilenceSampleCount;
+                        uint64 AheadOfPlay = TargetSampleIndex - SoundOutput.PlaySampleIndex;
+                        if ( AheadOfPlay + SilenceSampleCount >= BufferSampleCount )
+                        {
+                            SilenceSampleCount = (AheadOfPlay < BufferSampleCount) ? (BufferSampleCount - AheadOfPlay - 1) : 0;
+                        }
+                        SilenceBytes = (DWORD)SilenceSampleCount * SoundOutput.BytesPerSample;
+                        SoundIsValid = true;
+                    }
                 }
 
                 gfs_sound_buffer SoundBuffer = {};
                 SoundBuffer.SamplesPerSecond = SoundOutput.SamplesPerSecond;;
                 SoundBuffer.SampleCount = BytesToWrite / SoundOutput.BytesPerSample;
                 SoundBuffer.Samples = Samples;
+                SoundBuffer.RunningSampleIndex = SoundOutput.RunningSampleIndex;
+                SoundBuffer.FlipSampleIndex = FlipSampleIndex;
 
                 gfs_offscreen_buffer buffer = {};
                 buffer.Memory = GlobalBackBuffer.Memory;
@@ -625,18 +926,22 @@ int WinMain( HINSTANCE Instance, HINSTANCE PrevWindow, LPSTR CmdLine, int ShowCm
                 buffer.Height = GlobalBackBuffer.Height;
                 buffer.Pitch = GlobalBackBuffer.Pitch;
 
-                GameUpdateAndRender(&buffer, XOffset, YOffset, &SoundBuffer);
+                GameUpdateAndRender(&GameMemory, &buffer, XOffset, YOffset, &SoundBuffer, LastFrameSeconds);
 
                 //-------------------------------------------------------------------------------------------------
                 // NOTE(oyvind): DXsound output test
                 //-------------------------------------------------------------------------------------------------
+                BEGIN_TIMED_BLOCK( PlatformSound );
                 if(SoundIsValid )
                 {
-                    Win32FillSoundBuffer( &SoundOutput, BytesToLock, BytesToWrite, &SoundBuffer );
+                    Win32FillSoundBuffer( &SoundOutput, BytesToLock, BytesToWrite, SilenceBytes, &SoundBuffer );
                 }
+                END_TIMED_BLOCK( PlatformSound );
 
+                BEGIN_TIMED_BLOCK( PlatformBlit );
                 win32_window_dimension Dimension = Win32GetWindowDimension(Window);
                 Win32DisplayBufferInWindow(DeviceContext, GlobalBackBuffer, Dimension.Width, Dimension.Height);
+                END_TIMED_BLOCK( PlatformBlit );
 
 
                 //-------------------------------------------------------------------------------------------------
@@ -652,17 +957,32 @@ int WinMain( HINSTANCE Instance, HINSTANCE PrevWindow, LPSTR CmdLine, int ShowCm
 
                 real32 MSPerFrame = ((1000 * (real32)CounterElapsed) / (real32)PerfCountFrequency);
                 real32 FPS = (real32)PerfCountFrequency / (real32)CounterElapsed;
+                LastFrameSeconds = (real32)CounterElapsed / (real32)PerfCountFrequency;
                 real32 MegaCyclesPerFrame = (real32)CyclesElapsed / (1000 * 1000);
 
-                
-                // TODO(oyvind): Implement platform independent logging
-                //char LogBuffer[256];
-                //sprintf( LogBuffer, "%.03fms/f | %.02ff/s | %.02fmcy/f\n", MSPerFrame, FPS, MegaCyclesPerFrame );
-                //OutputDebugStringA( LogBuffer );
+                // NOTE(oyvind): Feeds the flip estimate for next frame's audio. Clamped so a
+                // breakpoint doesn't make us write seconds ahead, smoothed so one slow frame
+                // doesn't either.
+                int64 MeasuredFrameSampleCount = (CounterElapsed * SoundOutput.SamplesPerSecond) / PerfCountFrequency;
+                if ( MeasuredFrameSampleCount < SoundOutput.SamplesPerFrame / 4 ) MeasuredFrameSampleCount = SoundOutput.SamplesPerFrame / 4;
+                if ( MeasuredFrameSampleCount > SoundOutput.SamplesPerSecond / 10 ) MeasuredFrameSampleCount = SoundOutput.SamplesPerSecond / 10;
+                SoundOutput.ExpectedFrameSampleCount = (3 * SoundOutput.ExpectedFrameSampleCount + (int)MeasuredFrameSampleCount) / 4;
+
+
+                // NOTE(oyvind): Shown by the game on the next frame when the HUD is on (F2)
+                DebugEndFrame( &DebugState, MSPerFrame, FPS, MegaCyclesPerFrame );
 
                 LastCycleCount = EndCycleCount;
                 LastCounter = EndCounter;
+
+                if ( GlobalMemoryReportRequested )
+                {
+                    Win32OutputMemoryReport();
+                    GlobalMemoryReportRequested = false;
+                }
             }
+
+            Win32OutputMemoryReport();
         }
         else
         {